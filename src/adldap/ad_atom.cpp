@@ -0,0 +1,140 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ad_atom.h"
+
+#include <QHash>
+#include <QReadWriteLock>
+#include <QVector>
+
+class AdAtomData {
+public:
+    QString name;
+    int id;
+    uint hash;
+};
+
+// NOTE: atom data is never freed, so that pointers to it
+// stay valid for the lifetime of the process. Only names
+// from the schema and names returned by the server are
+// interned, so number of atoms is bounded by the schema.
+// Lookups of arbitrary names must use find(), which
+// doesn't create atoms.
+class AdAtomTable {
+public:
+    QReadWriteLock lock;
+    QHash<QString, const AdAtomData *> map;
+    QVector<const AdAtomData *> list;
+};
+
+// NOTE: using a f-n static to avoid static init order
+// issues, because atoms are used in static variables of
+// other files
+AdAtomTable *atom_table() {
+    static AdAtomTable table;
+
+    return &table;
+}
+
+AdAtom::AdAtom()
+: data(nullptr) {
+}
+
+AdAtom::AdAtom(const AdAtomData *data_arg)
+: data(data_arg) {
+}
+
+AdAtom AdAtom::intern(const QString &name) {
+    const AdAtom existing = find(name);
+    if (!existing.is_null()) {
+        return existing;
+    }
+
+    AdAtomTable *table = atom_table();
+
+    QWriteLocker locker(&table->lock);
+
+    // NOTE: need to check again because atom could've
+    // been created by another thread between the locks
+    const AdAtomData *data_found = table->map.value(name, nullptr);
+    if (data_found != nullptr) {
+        return AdAtom(data_found);
+    }
+
+    AdAtomData *data_new = new AdAtomData();
+    data_new->name = name;
+    data_new->id = table->list.size();
+    data_new->hash = qHash(name);
+
+    table->map.insert(name, data_new);
+    table->list.append(data_new);
+
+    return AdAtom(data_new);
+}
+
+AdAtom AdAtom::find(const QString &name) {
+    if (name.isEmpty()) {
+        return AdAtom();
+    }
+
+    AdAtomTable *table = atom_table();
+
+    QReadLocker locker(&table->lock);
+
+    const AdAtomData *data_found = table->map.value(name, nullptr);
+
+    return AdAtom(data_found);
+}
+
+int AdAtom::count() {
+    AdAtomTable *table = atom_table();
+
+    QReadLocker locker(&table->lock);
+
+    return table->list.size();
+}
+
+bool AdAtom::is_null() const {
+    return (data == nullptr);
+}
+
+QString AdAtom::name() const {
+    if (data != nullptr) {
+        return data->name;
+    } else {
+        return QString();
+    }
+}
+
+int AdAtom::id() const {
+    if (data != nullptr) {
+        return data->id;
+    } else {
+        return -1;
+    }
+}
+
+uint AdAtom::hash() const {
+    if (data != nullptr) {
+        return data->hash;
+    } else {
+        return 0;
+    }
+}
@@ -0,0 +1,83 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AD_ATOM_H
+#define AD_ATOM_H
+
+/**
+ * Interned attribute or class name. Atoms are created once
+ * per name for the whole process, so comparing two atoms
+ * is a pointer comparison and hashing an atom doesn't
+ * touch the string. Atoms are case-sensitive, same as
+ * the string keys they replace, so names should be spelled
+ * as in the schema. Each atom also has a dense integer id
+ * which can be used to index arrays.
+ */
+
+#include <QHashFunctions>
+#include <QString>
+
+class AdAtomData;
+
+class AdAtom {
+
+public:
+    // Creates a null atom
+    AdAtom();
+
+    // Returns atom for given name, creating it if needed.
+    // NOTE: atoms are never freed, so only intern names
+    // that come from the schema, use find() for lookups.
+    static AdAtom intern(const QString &name);
+
+    // Returns atom for given name if it was interned
+    // before, otherwise returns a null atom
+    static AdAtom find(const QString &name);
+
+    // Returns number of atoms, which is also an upper
+    // bound for atom id's
+    static int count();
+
+    bool is_null() const;
+
+    QString name() const;
+
+    int id() const;
+    uint hash() const;
+
+    bool operator==(const AdAtom &other) const {
+        return (data == other.data);
+    }
+
+    bool operator!=(const AdAtom &other) const {
+        return (data != other.data);
+    }
+
+private:
+    const AdAtomData *data;
+
+    AdAtom(const AdAtomData *data_arg);
+};
+
+inline uint qHash(const AdAtom &atom, uint seed = 0) {
+    return (atom.hash() ^ seed);
+}
+
+#endif /* AD_ATOM_H */
@@ -30,8 +30,14 @@
 #include "samba/ndr_security.h"
 
 #include <QCoreApplication>
+#include <QDataStream>
 #include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
 #include <QLocale>
+#include <QSaveFile>
+#include <QStandardPaths>
 #include <algorithm>
 
 #define ATTRIBUTE_ATTRIBUTE_DISPLAY_NAMES "attributeDisplayNames"
@@ -62,6 +68,17 @@
 
 #define FLAG_ATTR_IS_CONSTRUCTED 0x00000004
 
+#define ATTRIBUTE_OBJECT_VERSION "objectVersion"
+
+// NOTE: increment version when format of cache changes,
+// for example when attributes requested in fetch() change
+// How long to wait before searching for display
+// specifiers again after a failed search
+#define DISPLAY_SPECIFIER_RETRY_SECS 60
+
+#define ADCONFIG_CACHE_MAGIC 0x41444346
+#define ADCONFIG_CACHE_VERSION 4
+
 AdConfigPrivate::AdConfigPrivate() {
 }
 
@@ -80,10 +97,23 @@ void AdConfig::load(AdInterface &ad, const QLocale &locale) {
     d->columns.clear();
     d->column_display_names.clear();
     d->class_display_names.clear();
-    d->find_attributes.clear();
-    d->attribute_display_names.clear();
-    d->attribute_schemas.clear();
+    {
+        QMutexLocker locker(&d->display_specifier_mutex);
+        d->display_specifiers.clear();
+        d->display_specifier_retry_time = QDateTime();
+    }
+    d->attribute_descriptors.clear();
     d->class_schemas.clear();
+    d->right_to_guid_map.clear();
+    d->right_guid_to_cn_map.clear();
+    d->rights_guid_to_name_map.clear();
+    d->rights_name_to_guid_map.clear();
+    d->rights_applies_to_map.clear();
+    d->extended_rights_list.clear();
+    d->rights_valid_accesses_map.clear();
+    d->guid_to_attribute_map.clear();
+    d->guid_to_class_map.clear();
+    d->sub_class_of_map.clear();
 
     const AdObject rootDSE_object = ad.search_object(ROOT_DSE);
     d->domain_dn = rootDSE_object.get_string(ATTRIBUTE_ROOT_DOMAIN_NAMING_CONTEXT);
@@ -91,143 +121,334 @@ void AdConfig::load(AdInterface &ad, const QLocale &locale) {
     d->configuration_dn = rootDSE_object.get_string(ATTRIBUTE_CONFIGURATION_NAMING_CONTEXT);
     d->supported_control_list = rootDSE_object.get_strings(ATTRIBUTE_SUPPORTED_CONTROL);
 
-    const QString locale_dir = [this, locale]() {
-        const QString locale_code = [locale]() {
-            if (locale.language() == QLocale::Russian) {
-                return "419";
-            } else {
-                // English
-                return "409";
-            }
-        }();
+    const QString locale_code = [locale]() {
+        if (locale.language() == QLocale::Russian) {
+            return "419";
+        } else {
+            // English
+            return "409";
+        }
+    }();
 
-        return QString("CN=%1,CN=DisplaySpecifiers,%2").arg(locale_code, configuration_dn());
+    const QString locale_dir = QString("CN=%1,CN=DisplaySpecifiers,%2").arg(locale_code, configuration_dn());
+    d->locale_dir = locale_dir;
+
+    // NOTE: cache is invalidated when schema version or
+    // schema container changes. Only schema data is
+    // cached. Display specifiers and extended rights are
+    // in the configuration partition and can be edited
+    // without any change to the schema, so they are
+    // fetched every time.
+    const QString cache_key = [&]() {
+        const AdObject schema_object = ad.search_object(schema_dn(), {ATTRIBUTE_OBJECT_VERSION, ATTRIBUTE_WHEN_CHANGED});
+
+        if (schema_object.is_empty()) {
+            return QString();
+        }
+
+        const QString object_version = schema_object.get_string(ATTRIBUTE_OBJECT_VERSION);
+        const QString when_changed = schema_object.get_string(ATTRIBUTE_WHEN_CHANGED);
+
+        return QString("%1;%2;%3;%4").arg(domain_dn(), locale_dir, object_version, when_changed);
     }();
 
-    // Attribute schemas
-    {
-        const QString filter = filter_CONDITION(Condition_Equals, ATTRIBUTE_OBJECT_CLASS, CLASS_ATTRIBUTE_SCHEMA);
-
-        const QList<QString> attributes = {
-            ATTRIBUTE_LDAP_DISPLAY_NAME,
-            ATTRIBUTE_ATTRIBUTE_SYNTAX,
-            ATTRIBUTE_OM_SYNTAX,
-            ATTRIBUTE_IS_SINGLE_VALUED,
-            ATTRIBUTE_SYSTEM_ONLY,
-            ATTRIBUTE_RANGE_UPPER,
-            ATTRIBUTE_LINK_ID,
-            ATTRIBUTE_SYSTEM_FLAGS,
-            ATTRIBUTE_SCHEMA_ID_GUID,
-        };
+    const QString cache_path = [&]() {
+        const QString cache_dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+        const QString file_name = QString("adconfig_%1_%2.cache").arg(d->domain.toLower(), locale_code);
+
+        return QString("%1/%2").arg(cache_dir, file_name);
+    }();
+
+    AdConfigSearchResults results;
 
-        const QHash<QString, AdObject> results = ad.search(schema_dn(), SearchScope_Children, filter, attributes);
+    const bool loaded_from_cache = (!cache_key.isEmpty() && d->cache_read(cache_path, cache_key, &results));
 
-        for (const AdObject &object : results.values()) {
-            const QString attribute = object.get_string(ATTRIBUTE_LDAP_DISPLAY_NAME);
-            d->attribute_schemas[attribute] = object;
+    const bool fetch_schema = !loaded_from_cache;
+    d->fetch(ad, locale_dir, fetch_schema, &results);
 
-            const QByteArray guid = object.get_value(ATTRIBUTE_SCHEMA_ID_GUID);
-            d->guid_to_attribute_map[guid] = attribute;
+    if (fetch_schema) {
+        // NOTE: don't save cache if connection failed
+        // midway, otherwise incomplete data would be used
+        // until next schema change
+        const bool fetch_ok = (!cache_key.isEmpty() && !results.attribute_schemas.isEmpty() && !results.class_schemas.isEmpty());
+        if (fetch_ok) {
+            d->cache_write(cache_path, cache_key, results);
         }
     }
 
-    // Class schemas
-    {
-        const QString filter = filter_CONDITION(Condition_Equals, ATTRIBUTE_OBJECT_CLASS, CLASS_CLASS_SCHEMA);
-
-        const QList<QString> attributes = {
-            ATTRIBUTE_LDAP_DISPLAY_NAME,
-            ATTRIBUTE_POSSIBLE_SUPERIORS,
-            ATTRIBUTE_SYSTEM_POSSIBLE_SUPERIORS,
-            ATTRIBUTE_MAY_CONTAIN,
-            ATTRIBUTE_SYSTEM_MAY_CONTAIN,
-            ATTRIBUTE_MUST_CONTAIN,
-            ATTRIBUTE_SYSTEM_MUST_CONTAIN,
-            ATTRIBUTE_AUXILIARY_CLASS,
-            ATTRIBUTE_SYSTEM_AUXILIARY_CLASS,
-            ATTRIBUTE_SCHEMA_ID_GUID,
-            ATTRIBUTE_SUB_CLASS_OF,
-        };
+    d->process(results, this);
+
+    // Load display specifiers of container classes, which
+    // are shown in the console right away, and of classes
+    // used by filters, in one search. Other classes are
+    // loaded only if requested through
+    // load_display_specifiers().
+    const QList<ObjectClass> display_specifier_classes = d->filter_containers + filter_classes;
+    load_display_specifiers(ad, display_specifier_classes);
+}
+
+// NOTE: all searches are independent, so they are
+// performed concurrently. Load time is then bounded by
+// the slowest search instead of the sum of all of them.
+// Schema searches are skipped if schema was loaded from
+// cache.
+void AdConfigPrivate::fetch(AdInterface &ad, const QString &locale_dir, const bool fetch_schema, AdConfigSearchResults *out) {
+    AdSearchArgs attribute_schemas_args;
+    attribute_schemas_args.base = schema_dn;
+    attribute_schemas_args.scope = SearchScope_Children;
+    attribute_schemas_args.filter = filter_CONDITION(Condition_Equals, ATTRIBUTE_OBJECT_CLASS, CLASS_ATTRIBUTE_SCHEMA);
+    attribute_schemas_args.attributes = {
+        ATTRIBUTE_LDAP_DISPLAY_NAME,
+        ATTRIBUTE_ATTRIBUTE_SYNTAX,
+        ATTRIBUTE_OM_SYNTAX,
+        ATTRIBUTE_IS_SINGLE_VALUED,
+        ATTRIBUTE_SYSTEM_ONLY,
+        ATTRIBUTE_RANGE_UPPER,
+        ATTRIBUTE_LINK_ID,
+        ATTRIBUTE_SYSTEM_FLAGS,
+        ATTRIBUTE_SCHEMA_ID_GUID,
+    };
+
+    // NOTE: cn is needed to resolve filter container
+    // categories, because categories are class schema
+    // objects
+    AdSearchArgs class_schemas_args;
+    class_schemas_args.base = schema_dn;
+    class_schemas_args.scope = SearchScope_Children;
+    class_schemas_args.filter = filter_CONDITION(Condition_Equals, ATTRIBUTE_OBJECT_CLASS, CLASS_CLASS_SCHEMA);
+    class_schemas_args.attributes = {
+        ATTRIBUTE_CN,
+        ATTRIBUTE_LDAP_DISPLAY_NAME,
+        ATTRIBUTE_POSSIBLE_SUPERIORS,
+        ATTRIBUTE_SYSTEM_POSSIBLE_SUPERIORS,
+        ATTRIBUTE_MAY_CONTAIN,
+        ATTRIBUTE_SYSTEM_MAY_CONTAIN,
+        ATTRIBUTE_MUST_CONTAIN,
+        ATTRIBUTE_SYSTEM_MUST_CONTAIN,
+        ATTRIBUTE_AUXILIARY_CLASS,
+        ATTRIBUTE_SYSTEM_AUXILIARY_CLASS,
+        ATTRIBUTE_SCHEMA_ID_GUID,
+        ATTRIBUTE_SUB_CLASS_OF,
+    };
+
+    // NOTE: only class display names are loaded here.
+    // Attribute display names are much bigger and are
+    // loaded on demand, see display_specifier_load().
+    AdSearchArgs display_specifiers_args;
+    display_specifiers_args.base = locale_dir;
+    display_specifiers_args.scope = SearchScope_Children;
+    display_specifiers_args.attributes = {
+        ATTRIBUTE_CLASS_DISPLAY_NAME,
+    };
+
+    AdSearchArgs default_display_args;
+    default_display_args.base = QString("CN=default-Display,%1").arg(locale_dir);
+    default_display_args.scope = SearchScope_Object;
+    default_display_args.attributes = {ATTRIBUTE_EXTRA_COLUMNS};
+
+    AdSearchArgs ui_settings_args;
+    ui_settings_args.base = QString("CN=DS-UI-Default-Settings,%1").arg(locale_dir);
+    ui_settings_args.scope = SearchScope_Object;
+    ui_settings_args.attributes = {ATTRIBUTE_FILTER_CONTAINERS};
+
+    AdSearchArgs extended_rights_args;
+    extended_rights_args.base = QString("CN=Extended-Rights,%1").arg(configuration_dn);
+    extended_rights_args.scope = SearchScope_Children;
+    extended_rights_args.filter = filter_CONDITION(Condition_Equals, ATTRIBUTE_OBJECT_CLASS, CLASS_CONTROL_ACCESS_RIGHT);
+    extended_rights_args.attributes = {
+        ATTRIBUTE_CN,
+        ATTRIBUTE_DISPLAY_NAME,
+        ATTRIBUTE_RIGHTS_GUID,
+        ATTRIBUTE_APPLIES_TO,
+        ATTRIBUTE_VALID_ACCESSES,
+    };
+
+    QList<AdSearchArgs> args_list = {
+        display_specifiers_args,
+        default_display_args,
+        ui_settings_args,
+        extended_rights_args,
+    };
+
+    if (fetch_schema) {
+        args_list.append(attribute_schemas_args);
+        args_list.append(class_schemas_args);
+    }
 
-        const QHash<QString, AdObject> results = ad.search(schema_dn(), SearchScope_Children, filter, attributes);
+    const QList<QHash<QString, AdObject>> results = ad.search_concurrent(args_list);
 
-        for (const AdObject &object : results.values()) {
-            const QString object_class = object.get_string(ATTRIBUTE_LDAP_DISPLAY_NAME);
-            d->class_schemas[object_class] = object;
+    out->display_specifiers = results[0].values();
+    out->default_display = results[1].values().value(0);
+    out->ui_settings = results[2].values().value(0);
+    out->extended_rights = results[3].values();
 
-            const QByteArray guid = object.get_value(ATTRIBUTE_SCHEMA_ID_GUID);
-            d->guid_to_class_map[guid] = object_class;
+    if (fetch_schema) {
+        out->attribute_schemas = results[4].values();
+        out->class_schemas = results[5].values();
+    }
+}
+
+void AdConfigPrivate::attribute_descriptors_load(const QList<AdObject> &attribute_schemas) {
+    // NOTE: replica of: https://docs.microsoft.com/en-us/openspecs/windows_protocols/ms-adts/7cda533e-d7a4-4aec-a517-91d02ff4a1aa
+    // syntax -> om syntax list -> type
+    static QHash<QString, QHash<QString, AttributeType>> type_map = {
+        {"2.5.5.8", {{"1", AttributeType_Boolean}}},
+        {"2.5.5.9",
+            {
+                {"10", AttributeType_Enumeration},
+                {"2", AttributeType_Integer},
+            }},
+        {"2.5.5.16", {{"65", AttributeType_LargeInteger}}},
+        {"2.5.5.3", {{"27", AttributeType_StringCase}}},
+        {"2.5.5.5", {{"22", AttributeType_IA5}}},
+        {"2.5.5.15", {{"66", AttributeType_NTSecDesc}}},
+        {"2.5.5.6", {{"18", AttributeType_Numeric}}},
+        {"2.5.5.2", {{"6", AttributeType_ObjectIdentifier}}},
+        {"2.5.5.10",
+            {
+                {"4", AttributeType_Octet},
+                {"127", AttributeType_ReplicaLink},
+            }},
+        {"2.5.5.5", {{"19", AttributeType_Printable}}},
+        {"2.5.5.17", {{"4", AttributeType_Sid}}},
+        {"2.5.5.4", {{"20", AttributeType_Teletex}}},
+        {"2.5.5.12", {{"64", AttributeType_Unicode}}},
+        {"2.5.5.11",
+            {
+                {"23", AttributeType_UTCTime},
+                {"24", AttributeType_GeneralizedTime},
+            }},
+        {"2.5.5.14", {{"127", AttributeType_DNString}}},
+        {"2.5.5.7", {{"127", AttributeType_DNBinary}}},
+        {"2.5.5.1", {{"127", AttributeType_DSDN}}},
+    };
 
-            const QString sub_class_of = object.get_string(ATTRIBUTE_SUB_CLASS_OF);
-            d->sub_class_of_map[object_class] = sub_class_of;
+    const auto get_type = [&](const AdObject &schema) {
+        const QString attribute_syntax = schema.get_string(ATTRIBUTE_ATTRIBUTE_SYNTAX);
+        const QString om_syntax = schema.get_string(ATTRIBUTE_OM_SYNTAX);
+
+        if (type_map.contains(attribute_syntax) && type_map[attribute_syntax].contains(om_syntax)) {
+            return type_map[attribute_syntax][om_syntax];
+        } else {
+            return AttributeType_StringCase;
         }
+    };
+
+    // Manually remap large integer types to subtypes
+    static const QList<AdAtom> datetimes = {
+        AdAtom::intern(ATTRIBUTE_ACCOUNT_EXPIRES),
+        AdAtom::intern(ATTRIBUTE_LAST_LOGON),
+        AdAtom::intern(ATTRIBUTE_LAST_LOGON_TIMESTAMP),
+        AdAtom::intern(ATTRIBUTE_PWD_LAST_SET),
+        AdAtom::intern(ATTRIBUTE_LOCKOUT_TIME),
+        AdAtom::intern(ATTRIBUTE_BAD_PWD_TIME),
+    };
+    static const QList<AdAtom> timespans = {
+        AdAtom::intern(ATTRIBUTE_MAX_PWD_AGE),
+        AdAtom::intern(ATTRIBUTE_MIN_PWD_AGE),
+        AdAtom::intern(ATTRIBUTE_LOCKOUT_DURATION),
+    };
+
+    // NOTE: intern all atoms first, so that table can be
+    // sized once
+    QList<AdAtom> atom_list;
+    for (const AdObject &schema : attribute_schemas) {
+        const QString attribute = schema.get_string(ATTRIBUTE_LDAP_DISPLAY_NAME);
+        atom_list.append(AdAtom::intern(attribute));
     }
 
-    // Class display specifiers
-    // NOTE: can't just store objects for these because the values require a decent amount of preprocessing which is best done once here, not everytime value is requested
-    {
-        const QString filter = QString();
+    attribute_descriptors = QVector<AdAttributeDescriptor>(AdAtom::count());
 
-        const QList<QString> search_attributes = {
-            ATTRIBUTE_CLASS_DISPLAY_NAME,
-            ATTRIBUTE_ATTRIBUTE_DISPLAY_NAMES,
-        };
+    for (int i = 0; i < attribute_schemas.size(); i++) {
+        const AdObject &schema = attribute_schemas[i];
+        AdAttributeDescriptor &descriptor = attribute_descriptors[atom_list[i].id()];
 
-        const QHash<QString, AdObject> results = ad.search(locale_dir, SearchScope_Children, filter, search_attributes);
+        descriptor.type = get_type(schema);
+        descriptor.is_single_valued = schema.get_bool(ATTRIBUTE_IS_SINGLE_VALUED);
+        descriptor.is_system_only = schema.get_bool(ATTRIBUTE_SYSTEM_ONLY);
+        descriptor.range_upper = schema.get_int(ATTRIBUTE_RANGE_UPPER);
+        descriptor.link_id = schema.get_int(ATTRIBUTE_LINK_ID);
+        descriptor.is_backlink = (schema.contains(ATTRIBUTE_LINK_ID) && descriptor.link_id % 2 != 0);
 
-        for (const AdObject &object : results) {
-            const QString dn = object.get_dn();
+        const int system_flags = schema.get_int(ATTRIBUTE_SYSTEM_FLAGS);
+        descriptor.is_constructed = bitmask_is_set(system_flags, FLAG_ATTR_IS_CONSTRUCTED);
+    }
 
-            // Display specifier DN is "CN=object-class-Display,CN=..."
-            // Get "object-class" from that
-            const QString object_class = [dn]() {
-                const QString rdn = dn.split(",")[0];
-                QString out = rdn;
-                out.remove("CN=", Qt::CaseInsensitive);
-                out.remove("-Display");
+    // NOTE: subtypes don't depend on schema, so they are
+    // set even for attributes missing from schema
+    for (const AdAtom &attribute : datetimes) {
+        attribute_descriptors[attribute.id()].large_integer_subtype = LargeIntegerSubtype_Datetime;
+    }
+    for (const AdAtom &attribute : timespans) {
+        attribute_descriptors[attribute.id()].large_integer_subtype = LargeIntegerSubtype_Timespan;
+    }
+}
 
-                return out;
-            }();
+const AdAttributeDescriptor &AdConfigPrivate::attribute_descriptor(const AdAtom &attribute) const {
+    static const AdAttributeDescriptor default_descriptor;
 
-            if (object.contains(ATTRIBUTE_CLASS_DISPLAY_NAME)) {
-                d->class_display_names[object_class] = object.get_string(ATTRIBUTE_CLASS_DISPLAY_NAME);
-            }
+    if (attribute.is_null()) {
+        return default_descriptor;
+    }
+
+    const int id = attribute.id();
+
+    if (id < attribute_descriptors.size()) {
+        return attribute_descriptors[id];
+    } else {
+        return default_descriptor;
+    }
+}
 
-            if (object.contains(ATTRIBUTE_ATTRIBUTE_DISPLAY_NAMES)) {
-                const QList<QString> display_names = object.get_strings(ATTRIBUTE_ATTRIBUTE_DISPLAY_NAMES);
+// NOTE: dns-Zone category is mispelled in
+// ATTRIBUTE_FILTER_CONTAINERS, no idea why, might just be
+// on this domain version
+QList<QString> AdConfigPrivate::get_filter_container_categories(const AdObject &ui_settings) {
+    QList<QString> out = ui_settings.get_strings(ATTRIBUTE_FILTER_CONTAINERS);
+    out.replaceInStrings("dns-Zone", "Dns-Zone");
 
-                for (const auto &display_name_pair : display_names) {
-                    const QList<QString> split = display_name_pair.split(",");
-                    const QString attribute_name = split[0];
-                    const QString display_name = split[1];
+    return out;
+}
+
+void AdConfigPrivate::process(const AdConfigSearchResults &results, const AdConfig *adconfig) {
+    // Attribute schemas
+    attribute_descriptors_load(results.attribute_schemas);
+
+    for (const AdObject &object : results.attribute_schemas) {
+        const QString attribute = object.get_string(ATTRIBUTE_LDAP_DISPLAY_NAME);
 
-                    d->attribute_display_names[object_class][attribute_name] = display_name;
-                }
+        const QByteArray guid = object.get_value(ATTRIBUTE_SCHEMA_ID_GUID);
+        guid_to_attribute_map[guid] = attribute;
+    }
 
-                d->find_attributes[object_class] = [object_class, display_names]() {
-                    QList<QString> out;
+    // Class schemas
+    for (const AdObject &object : results.class_schemas) {
+        const QString object_class = object.get_string(ATTRIBUTE_LDAP_DISPLAY_NAME);
+        const AdAtom object_class_atom = AdAtom::intern(object_class);
+        class_schemas[object_class_atom] = object;
 
-                    for (const auto &display_name_pair : display_names) {
-                        const QList<QString> split = display_name_pair.split(",");
-                        const QString attribute = split[0];
+        const QByteArray guid = object.get_value(ATTRIBUTE_SCHEMA_ID_GUID);
+        guid_to_class_map[guid] = object_class;
 
-                        out.append(attribute);
-                    }
+        const QString sub_class_of = object.get_string(ATTRIBUTE_SUB_CLASS_OF);
+        sub_class_of_map[object_class_atom] = sub_class_of;
+    }
 
-                    return out;
-                }();
-            }
+    // Class display names
+    for (const AdObject &object : results.display_specifiers) {
+        const QString object_class = display_specifier_dn_to_class(object.get_dn());
+        const AdAtom object_class_atom = AdAtom::intern(object_class);
+
+        if (object.contains(ATTRIBUTE_CLASS_DISPLAY_NAME)) {
+            class_display_names[object_class_atom] = object.get_string(ATTRIBUTE_CLASS_DISPLAY_NAME);
         }
     }
 
     // Columns
     {
         const QList<QString> columns_values = [&] {
-            const QString dn = QString("CN=default-Display,%1").arg(locale_dir);
-            const AdObject object = ad.search_object(dn, {ATTRIBUTE_EXTRA_COLUMNS});
-
             // NOTE: order as stored in attribute is reversed. Order is not sorted alphabetically so can't just sort.
-            QList<QString> extra_columns = object.get_strings(ATTRIBUTE_EXTRA_COLUMNS);
+            QList<QString> extra_columns = results.default_display.get_strings(ATTRIBUTE_EXTRA_COLUMNS);
             std::reverse(extra_columns.begin(), extra_columns.end());
 
             return extra_columns;
@@ -246,14 +467,14 @@ void AdConfig::load(AdInterface &ad, const QLocale &locale) {
             const QString attribute = column_split[0];
             const QString attribute_display_name = column_split[1];
 
-            d->columns.append(attribute);
-            d->column_display_names[attribute] = attribute_display_name;
+            columns.append(attribute);
+            column_display_names[AdAtom::intern(attribute)] = attribute_display_name;
         }
 
         // Insert some columns manually
         auto add_custom = [=](const Attribute &attribute, const QString &display_name) {
-            d->columns.prepend(attribute);
-            d->column_display_names[attribute] = display_name;
+            columns.prepend(attribute);
+            column_display_names[AdAtom::intern(attribute)] = display_name;
         };
 
         add_custom(ATTRIBUTE_DN, QCoreApplication::translate("AdConfig", "Distinguished name"));
@@ -262,29 +483,29 @@ void AdConfig::load(AdInterface &ad, const QLocale &locale) {
         add_custom(ATTRIBUTE_NAME, QCoreApplication::translate("AdConfig", "Name"));
     }
 
-    d->filter_containers = [&] {
+    filter_containers = [&] {
         QList<QString> out;
 
-        const QString ui_settings_dn = QString("CN=DS-UI-Default-Settings,%1").arg(locale_dir);
-        const AdObject object = ad.search_object(ui_settings_dn, {ATTRIBUTE_FILTER_CONTAINERS});
+        // NOTE: ATTRIBUTE_FILTER_CONTAINERS contains object
+        // *categories* not classes. Categories are class
+        // schema objects, so get object class from class
+        // schema with matching cn.
+        const QHash<QString, QString> category_to_class_map = [&]() {
+            QHash<QString, QString> map_out;
 
-        // NOTE: dns-Zone category is mispelled in
-        // ATTRIBUTE_FILTER_CONTAINERS, no idea why, might
-        // just be on this domain version
-        const QList<QString> categories = [object]() {
-            QList<QString> categories_out = object.get_strings(ATTRIBUTE_FILTER_CONTAINERS);
-            categories_out.replaceInStrings("dns-Zone", "Dns-Zone");
+            for (const AdObject &object : results.class_schemas) {
+                const QString cn = object.get_string(ATTRIBUTE_CN).toLower();
+                const QString object_class = object.get_string(ATTRIBUTE_LDAP_DISPLAY_NAME);
 
-            return categories_out;
+                map_out[cn] = object_class;
+            }
+
+            return map_out;
         }();
 
-        // NOTE: ATTRIBUTE_FILTER_CONTAINERS contains object
-        // *categories* not classes, so need to get object
-        // class from category object
+        const QList<QString> categories = get_filter_container_categories(results.ui_settings);
         for (const auto &object_category : categories) {
-            const QString category_dn = QString("CN=%1,%2").arg(object_category, schema_dn());
-            const AdObject category_object = ad.search_object(category_dn, {ATTRIBUTE_LDAP_DISPLAY_NAME});
-            const QString object_class = category_object.get_string(ATTRIBUTE_LDAP_DISPLAY_NAME);
+            const QString object_class = category_to_class_map.value(object_category.toLower());
 
             out.append(object_class);
         }
@@ -299,49 +520,295 @@ void AdConfig::load(AdInterface &ad, const QLocale &locale) {
     }();
 
     // Extended rights
-    {
-        const QString filter = filter_CONDITION(Condition_Equals, ATTRIBUTE_OBJECT_CLASS, CLASS_CONTROL_ACCESS_RIGHT);
-
-        const QList<QString> attributes = {
-            ATTRIBUTE_CN,
-            ATTRIBUTE_DISPLAY_NAME,
-            ATTRIBUTE_RIGHTS_GUID,
-            ATTRIBUTE_APPLIES_TO,
-            ATTRIBUTE_VALID_ACCESSES,
-        };
+    for (const AdObject &object : results.extended_rights) {
+        const QString cn = object.get_string(ATTRIBUTE_CN);
+        const QString guid_string = object.get_string(ATTRIBUTE_RIGHTS_GUID);
+        const QByteArray guid = guid_string_to_bytes(guid_string);
+        const QByteArray display_name = object.get_value(ATTRIBUTE_DISPLAY_NAME);
+        const QList<QString> applies_to = [adconfig, object]() {
+            QList<QString> out;
+
+            const QList<QString> class_guid_string_list = object.get_strings(ATTRIBUTE_APPLIES_TO);
+            for (const QString &class_guid_string : class_guid_string_list) {
+                const QByteArray class_guid = guid_string_to_bytes(class_guid_string);
+                const QString object_class = adconfig->guid_to_class(class_guid);
+
+                out.append(object_class);
+            }
 
-        const QString search_base = extended_rights_dn();
-
-        const QHash<QString, AdObject> search_results = ad.search(search_base, SearchScope_Children, filter, attributes);
-
-        for (const AdObject &object : search_results.values()) {
-            const QString cn = object.get_string(ATTRIBUTE_CN);
-            const QString guid_string = object.get_string(ATTRIBUTE_RIGHTS_GUID);
-            const QByteArray guid = guid_string_to_bytes(guid_string);
-            const QByteArray display_name = object.get_value(ATTRIBUTE_DISPLAY_NAME);
-            const QList<QString> applies_to = [this, object]() {
-                QList<QString> out;
-
-                const QList<QString> class_guid_string_list = object.get_strings(ATTRIBUTE_APPLIES_TO);
-                for (const QString &class_guid_string : class_guid_string_list) {
-                    const QByteArray class_guid = guid_string_to_bytes(class_guid_string);
-                    const QString object_class = guid_to_class(class_guid);
-
-                    out.append(object_class);
-                }
-
-                return out;
-            }();
-            const int valid_accesses = object.get_int(ATTRIBUTE_VALID_ACCESSES);
-
-            d->right_to_guid_map[cn] = guid;
-            d->right_guid_to_cn_map[guid] = cn;
-            d->rights_guid_to_name_map[guid] = display_name;
-            d->rights_name_to_guid_map[cn] = guid;
-            d->rights_applies_to_map[guid] = applies_to;
-            d->extended_rights_list.append(cn);
-            d->rights_valid_accesses_map[cn] = valid_accesses;
+            return out;
+        }();
+        const int valid_accesses = object.get_int(ATTRIBUTE_VALID_ACCESSES);
+
+        right_to_guid_map[cn] = guid;
+        right_guid_to_cn_map[guid] = cn;
+        rights_guid_to_name_map[guid] = display_name;
+        rights_name_to_guid_map[cn] = guid;
+        rights_applies_to_map[guid] = applies_to;
+        extended_rights_list.append(cn);
+        rights_valid_accesses_map[cn] = valid_accesses;
+    }
+}
+
+// Display specifier DN is "CN=object-class-Display,CN=..."
+// Get "object-class" from that
+QString AdConfigPrivate::display_specifier_dn_to_class(const QString &dn) {
+    const QString rdn = dn.split(",")[0];
+    QString out = rdn;
+    out.remove("CN=", Qt::CaseInsensitive);
+    out.remove("-Display");
+
+    return out;
+}
+
+// Loads display specifiers of classes that are not loaded
+// yet. Returns false if search failed, in which case
+// nothing is stored and loading is skipped until retry
+// time, so that a missing locale container or a broken
+// connection doesn't cost a search on every call.
+// NOTE: search is done without holding the mutex, so that
+// other threads don't wait for the network
+bool AdConfigPrivate::display_specifier_load(AdInterface &ad, const QList<AdAtom> &class_list) {
+    const QList<AdAtom> missing_list = [&]() {
+        QMutexLocker locker(&display_specifier_mutex);
+
+        QList<AdAtom> out;
+
+        const bool retry_later = (display_specifier_retry_time.isValid() && QDateTime::currentDateTimeUtc() < display_specifier_retry_time);
+        if (retry_later) {
+            return out;
+        }
+
+        for (const AdAtom &object_class : class_list) {
+            if (!object_class.is_null() && !display_specifiers.contains(object_class) && !out.contains(object_class)) {
+                out.append(object_class);
+            }
         }
+
+        return out;
+    }();
+
+    if (missing_list.isEmpty()) {
+        return true;
+    }
+
+    const QString filter = [&]() {
+        QList<QString> subfilters;
+
+        for (const AdAtom &object_class : missing_list) {
+            const QString cn = QString("%1-Display").arg(object_class.name());
+            const QString subfilter = filter_CONDITION(Condition_Equals, ATTRIBUTE_CN, cn);
+
+            subfilters.append(subfilter);
+        }
+
+        return filter_OR(subfilters);
+    }();
+
+    QHash<QString, AdObject> results;
+    AdCookie cookie;
+
+    while (true) {
+        const bool success = ad.search_paged(locale_dir, SearchScope_Children, filter, {ATTRIBUTE_ATTRIBUTE_DISPLAY_NAMES}, &results, &cookie);
+
+        if (!success) {
+            QMutexLocker locker(&display_specifier_mutex);
+            display_specifier_retry_time = QDateTime::currentDateTimeUtc().addSecs(DISPLAY_SPECIFIER_RETRY_SECS);
+
+            return false;
+        }
+
+        if (!cookie.more_pages()) {
+            break;
+        }
+    }
+
+    // NOTE: classes that don't have a display specifier
+    // get an empty one, so that they are not searched for
+    // again
+    QHash<AdAtom, AdDisplaySpecifier> loaded;
+    for (const AdAtom &object_class : missing_list) {
+        loaded[object_class] = AdDisplaySpecifier();
+    }
+
+    // NOTE: cn's of display specifiers may be spelled in
+    // different case than class names
+    QHash<QString, AdAtom> missing_map;
+    for (const AdAtom &object_class : missing_list) {
+        missing_map[object_class.name().toLower()] = object_class;
+    }
+
+    for (const AdObject &object : results.values()) {
+        const QString object_class = display_specifier_dn_to_class(object.get_dn());
+        const AdAtom object_class_atom = missing_map.value(object_class.toLower());
+
+        if (object_class_atom.is_null()) {
+            continue;
+        }
+
+        AdDisplaySpecifier specifier;
+
+        // NOTE: value is "$attribute,$display_name". Each
+        // value is split once and used for both display
+        // names and find attributes.
+        const QList<QString> display_names = object.get_strings(ATTRIBUTE_ATTRIBUTE_DISPLAY_NAMES);
+        for (const auto &display_name_pair : display_names) {
+            const QList<QString> split = display_name_pair.split(",");
+
+            if (split.size() < 2) {
+                continue;
+            }
+
+            const QString attribute_name = split[0];
+            const QString display_name = split[1];
+
+            specifier.attribute_display_names[AdAtom::intern(attribute_name)] = display_name;
+            specifier.find_attributes.append(attribute_name);
+        }
+
+        loaded[object_class_atom] = specifier;
+    }
+
+    QMutexLocker locker(&display_specifier_mutex);
+
+    for (const AdAtom &object_class : loaded.keys()) {
+        if (!display_specifiers.contains(object_class)) {
+            display_specifiers[object_class] = loaded[object_class];
+        }
+    }
+
+    return true;
+}
+
+// Returns display specifier for class. If it wasn't
+// loaded, returns an empty specifier.
+// NOTE: getters call this, possibly from the GUI thread,
+// so this doesn't search. Load specifiers beforehand
+// using load_display_specifiers().
+AdDisplaySpecifier AdConfigPrivate::display_specifier_get(const AdAtom &object_class) {
+    QMutexLocker locker(&display_specifier_mutex);
+
+    return display_specifiers.value(object_class);
+}
+
+void AdConfig::load_display_specifiers(AdInterface &ad, const QList<ObjectClass> &class_list) {
+    const QList<AdAtom> atom_list = [&]() {
+        QList<AdAtom> out;
+
+        for (const ObjectClass &object_class : class_list) {
+            const AdAtom object_class_atom = AdAtom::find(object_class);
+
+            if (!object_class_atom.is_null()) {
+                out.append(object_class_atom);
+            }
+        }
+
+        return out;
+    }();
+
+    d->display_specifier_load(ad, atom_list);
+}
+
+// NOTE: objects are stored as dn + attributes data, which
+// is enough to recreate them using AdObject::load()
+void write_object_list(QDataStream &stream, const QList<AdObject> &object_list) {
+    stream << (qint32) object_list.size();
+
+    for (const AdObject &object : object_list) {
+        stream << object.get_dn();
+        stream << object.get_attributes_data();
+    }
+}
+
+QList<AdObject> read_object_list(QDataStream &stream) {
+    QList<AdObject> out;
+
+    qint32 size;
+    stream >> size;
+
+    for (int i = 0; i < size && stream.status() == QDataStream::Ok; i++) {
+        QString dn;
+        QHash<QString, QList<QByteArray>> attributes_data;
+        stream >> dn;
+        stream >> attributes_data;
+
+        AdObject object;
+        object.load(dn, attributes_data);
+
+        out.append(object);
+    }
+
+    return out;
+}
+
+bool AdConfigPrivate::cache_read(const QString &path, const QString &key, AdConfigSearchResults *out) {
+    QFile file(path);
+
+    const bool open_success = file.open(QIODevice::ReadOnly);
+    if (!open_success) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic;
+    qint32 version;
+    QString file_key;
+    stream >> magic;
+    stream >> version;
+    stream >> file_key;
+
+    const bool header_ok = (stream.status() == QDataStream::Ok && magic == ADCONFIG_CACHE_MAGIC && version == ADCONFIG_CACHE_VERSION && file_key == key);
+    if (!header_ok) {
+        return false;
+    }
+
+    AdConfigSearchResults results;
+    results.attribute_schemas = read_object_list(stream);
+    results.class_schemas = read_object_list(stream);
+
+    if (stream.status() != QDataStream::Ok) {
+        qDebug() << "AdConfig cache is corrupted, ignoring it";
+
+        return false;
+    }
+
+    out->attribute_schemas = results.attribute_schemas;
+    out->class_schemas = results.class_schemas;
+
+    return true;
+}
+
+void AdConfigPrivate::cache_write(const QString &path, const QString &key, const AdConfigSearchResults &results) {
+    const QString dir = QFileInfo(path).absolutePath();
+    QDir().mkpath(dir);
+
+    // NOTE: write to temp file first and then rename, so
+    // that another instance doesn't read a partially
+    // written cache
+    QSaveFile file(path);
+
+    const bool open_success = file.open(QIODevice::WriteOnly);
+    if (!open_success) {
+        qDebug() << "Failed to open AdConfig cache for writing:" << path;
+
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    stream << (quint32) ADCONFIG_CACHE_MAGIC;
+    stream << (qint32) ADCONFIG_CACHE_VERSION;
+    stream << key;
+
+    write_object_list(stream, results.attribute_schemas);
+    write_object_list(stream, results.class_schemas);
+
+    const bool commit_success = file.commit();
+    if (!commit_success) {
+        qDebug() << "Failed to write AdConfig cache:" << path;
     }
 }
 
@@ -380,36 +847,67 @@ bool AdConfig::control_is_supported(const QString &control_oid) const {
 }
 
 QString AdConfig::get_attribute_display_name(const Attribute &attribute, const ObjectClass &objectClass) const {
-    if (d->attribute_display_names.contains(objectClass) && d->attribute_display_names[objectClass].contains(attribute)) {
-        const QString display_name = d->attribute_display_names[objectClass][attribute];
+    const AdAtom attribute_atom = AdAtom::find(attribute);
+    if (attribute_atom.is_null()) {
+        return attribute;
+    }
 
-        return display_name;
+    return get_attribute_display_name(attribute_atom, AdAtom::find(objectClass));
+}
+
+QString AdConfig::get_attribute_display_name(const AdAtom &attribute, const AdAtom &objectClass) const {
+    {
+        const AdDisplaySpecifier specifier = d->display_specifier_get(objectClass);
+        if (specifier.attribute_display_names.contains(attribute)) {
+            const QString display_name = specifier.attribute_display_names[attribute];
+
+            return display_name;
+        }
     }
 
     // NOTE: display specifier doesn't cover all attributes for all classes, so need to hardcode some of them here
-    static const QHash<Attribute, QString> fallback_display_names = {
-        {ATTRIBUTE_NAME, QCoreApplication::translate("AdConfig", "Name")},
-        {ATTRIBUTE_DN, QCoreApplication::translate("AdConfig", "Distinguished name")},
-        {ATTRIBUTE_OBJECT_CLASS, QCoreApplication::translate("AdConfig", "Object class")},
-        {ATTRIBUTE_WHEN_CREATED, QCoreApplication::translate("AdConfig", "Created")},
-        {ATTRIBUTE_WHEN_CHANGED, QCoreApplication::translate("AdConfig", "Changed")},
-        {ATTRIBUTE_USN_CREATED, QCoreApplication::translate("AdConfig", "USN created")},
-        {ATTRIBUTE_USN_CHANGED, QCoreApplication::translate("AdConfig", "USN changed")},
-        {ATTRIBUTE_ACCOUNT_EXPIRES, QCoreApplication::translate("AdConfig", "Account expires")},
-        {ATTRIBUTE_OBJECT_CATEGORY, QCoreApplication::translate("AdConfig", "Type")},
-        {ATTRIBUTE_PROFILE_PATH, QCoreApplication::translate("AdConfig", "Profile path")},
-        {ATTRIBUTE_SCRIPT_PATH, QCoreApplication::translate("AdConfig", "Logon script")},
-        {ATTRIBUTE_SAM_ACCOUNT_NAME, QCoreApplication::translate("AdConfig", "Logon name (pre-Windows 2000)")},
-        {ATTRIBUTE_MAIL, QCoreApplication::translate("AdConfig", "E-mail")},
-        {ATTRIBUTE_LOCATION, QCoreApplication::translate("AdConfig", "Location")},
-        {ATTRIBUTE_MANAGED_BY, QCoreApplication::translate("managedBy", "Managed by")},
-    };
+    static const QHash<AdAtom, QString> fallback_display_names = []() {
+        const QHash<Attribute, QString> fallback_display_names_strings = {
+            {ATTRIBUTE_NAME, QCoreApplication::translate("AdConfig", "Name")},
+            {ATTRIBUTE_DN, QCoreApplication::translate("AdConfig", "Distinguished name")},
+            {ATTRIBUTE_OBJECT_CLASS, QCoreApplication::translate("AdConfig", "Object class")},
+            {ATTRIBUTE_WHEN_CREATED, QCoreApplication::translate("AdConfig", "Created")},
+            {ATTRIBUTE_WHEN_CHANGED, QCoreApplication::translate("AdConfig", "Changed")},
+            {ATTRIBUTE_USN_CREATED, QCoreApplication::translate("AdConfig", "USN created")},
+            {ATTRIBUTE_USN_CHANGED, QCoreApplication::translate("AdConfig", "USN changed")},
+            {ATTRIBUTE_ACCOUNT_EXPIRES, QCoreApplication::translate("AdConfig", "Account expires")},
+            {ATTRIBUTE_OBJECT_CATEGORY, QCoreApplication::translate("AdConfig", "Type")},
+            {ATTRIBUTE_PROFILE_PATH, QCoreApplication::translate("AdConfig", "Profile path")},
+            {ATTRIBUTE_SCRIPT_PATH, QCoreApplication::translate("AdConfig", "Logon script")},
+            {ATTRIBUTE_SAM_ACCOUNT_NAME, QCoreApplication::translate("AdConfig", "Logon name (pre-Windows 2000)")},
+            {ATTRIBUTE_MAIL, QCoreApplication::translate("AdConfig", "E-mail")},
+            {ATTRIBUTE_LOCATION, QCoreApplication::translate("AdConfig", "Location")},
+            {ATTRIBUTE_MANAGED_BY, QCoreApplication::translate("managedBy", "Managed by")},
+        };
+
+        QHash<AdAtom, QString> out;
+
+        for (const Attribute &fallback_attribute : fallback_display_names_strings.keys()) {
+            out[AdAtom::intern(fallback_attribute)] = fallback_display_names_strings[fallback_attribute];
+        }
 
-    return fallback_display_names.value(attribute, attribute);
+        return out;
+    }();
+
+    return fallback_display_names.value(attribute, attribute.name());
 }
 
 QString AdConfig::get_class_display_name(const QString &objectClass) const {
-    return d->class_display_names.value(objectClass, objectClass);
+    const AdAtom class_atom = AdAtom::find(objectClass);
+    if (class_atom.is_null()) {
+        return objectClass;
+    }
+
+    return get_class_display_name(class_atom);
+}
+
+QString AdConfig::get_class_display_name(const AdAtom &objectClass) const {
+    return d->class_display_names.value(objectClass, objectClass.name());
 }
 
 QList<QString> AdConfig::get_columns() const {
@@ -417,7 +915,16 @@ QList<QString> AdConfig::get_columns() const {
 }
 
 QString AdConfig::get_column_display_name(const Attribute &attribute) const {
-    return d->column_display_names.value(attribute, attribute);
+    const AdAtom attribute_atom = AdAtom::find(attribute);
+    if (attribute_atom.is_null()) {
+        return attribute;
+    }
+
+    return get_column_display_name(attribute_atom);
+}
+
+QString AdConfig::get_column_display_name(const AdAtom &attribute) const {
+    return d->column_display_names.value(attribute, attribute.name());
 }
 
 int AdConfig::get_column_index(const QString &attribute) const {
@@ -436,7 +943,7 @@ QList<QString> AdConfig::get_possible_superiors(const QList<ObjectClass> &object
     QList<QString> out;
 
     for (const QString &object_class : object_classes) {
-        const AdObject schema = d->class_schemas[object_class];
+        const AdObject schema = d->class_schemas.value(AdAtom::find(object_class));
         out += schema.get_strings(ATTRIBUTE_POSSIBLE_SUPERIORS);
         out += schema.get_strings(ATTRIBUTE_SYSTEM_POSSIBLE_SUPERIORS);
     }
@@ -447,7 +954,7 @@ QList<QString> AdConfig::get_possible_superiors(const QList<ObjectClass> &object
 }
 
 ObjectClass AdConfig::get_parent_class(const ObjectClass &object_class) const {
-    const ObjectClass out = d->sub_class_of_map.value(object_class);
+    const ObjectClass out = d->sub_class_of_map.value(AdAtom::find(object_class));
 
     return out;
 }
@@ -480,7 +987,7 @@ QList<QString> AdConfig::get_optional_attributes(const QList<QString> &object_cl
     QList<QString> attributes;
 
     for (const auto &object_class : all_classes) {
-        const AdObject schema = d->class_schemas[object_class];
+        const AdObject schema = d->class_schemas.value(AdAtom::find(object_class));
         attributes += schema.get_strings(ATTRIBUTE_MAY_CONTAIN);
         attributes += schema.get_strings(ATTRIBUTE_SYSTEM_MAY_CONTAIN);
     }
@@ -496,7 +1003,7 @@ QList<QString> AdConfig::get_mandatory_attributes(const QList<QString> &object_c
     QList<QString> attributes;
 
     for (const auto &object_class : all_classes) {
-        const AdObject schema = d->class_schemas[object_class];
+        const AdObject schema = d->class_schemas.value(AdAtom::find(object_class));
         attributes += schema.get_strings(ATTRIBUTE_MUST_CONTAIN);
         attributes += schema.get_strings(ATTRIBUTE_SYSTEM_MUST_CONTAIN);
     }
@@ -507,82 +1014,32 @@ QList<QString> AdConfig::get_mandatory_attributes(const QList<QString> &object_c
 }
 
 QList<QString> AdConfig::get_find_attributes(const QString &object_class) const {
-    return d->find_attributes.value(object_class, QList<QString>());
+    const AdDisplaySpecifier specifier = d->display_specifier_get(AdAtom::find(object_class));
+
+    return specifier.find_attributes;
 }
 
 AttributeType AdConfig::get_attribute_type(const QString &attribute) const {
-    // NOTE: replica of: https://docs.microsoft.com/en-us/openspecs/windows_protocols/ms-adts/7cda533e-d7a4-4aec-a517-91d02ff4a1aa
-    // syntax -> om syntax list -> type
-    static QHash<QString, QHash<QString, AttributeType>> type_map = {
-        {"2.5.5.8", {{"1", AttributeType_Boolean}}},
-        {"2.5.5.9",
-            {
-                {"10", AttributeType_Enumeration},
-                {"2", AttributeType_Integer},
-            }},
-        {"2.5.5.16", {{"65", AttributeType_LargeInteger}}},
-        {"2.5.5.3", {{"27", AttributeType_StringCase}}},
-        {"2.5.5.5", {{"22", AttributeType_IA5}}},
-        {"2.5.5.15", {{"66", AttributeType_NTSecDesc}}},
-        {"2.5.5.6", {{"18", AttributeType_Numeric}}},
-        {"2.5.5.2", {{"6", AttributeType_ObjectIdentifier}}},
-        {"2.5.5.10",
-            {
-                {"4", AttributeType_Octet},
-                {"127", AttributeType_ReplicaLink},
-            }},
-        {"2.5.5.5", {{"19", AttributeType_Printable}}},
-        {"2.5.5.17", {{"4", AttributeType_Sid}}},
-        {"2.5.5.4", {{"20", AttributeType_Teletex}}},
-        {"2.5.5.12", {{"64", AttributeType_Unicode}}},
-        {"2.5.5.11",
-            {
-                {"23", AttributeType_UTCTime},
-                {"24", AttributeType_GeneralizedTime},
-            }},
-        {"2.5.5.14", {{"127", AttributeType_DNString}}},
-        {"2.5.5.7", {{"127", AttributeType_DNBinary}}},
-        {"2.5.5.1", {{"127", AttributeType_DSDN}}},
-    };
-
-    const AdObject schema = d->attribute_schemas[attribute];
-
-    const QString attribute_syntax = schema.get_string(ATTRIBUTE_ATTRIBUTE_SYNTAX);
-    const QString om_syntax = schema.get_string(ATTRIBUTE_OM_SYNTAX);
+    return get_attribute_type(AdAtom::find(attribute));
+}
 
-    if (type_map.contains(attribute_syntax) && type_map[attribute_syntax].contains(om_syntax)) {
-        return type_map[attribute_syntax][om_syntax];
-    } else {
-        return AttributeType_StringCase;
-    }
+AttributeType AdConfig::get_attribute_type(const AdAtom &attribute) const {
+    return d->attribute_descriptor(attribute).type;
 }
 
 LargeIntegerSubtype AdConfig::get_attribute_large_integer_subtype(const QString &attribute) const {
-    // Manually remap large integer types to subtypes
-    static const QList<QString> datetimes = {
-        ATTRIBUTE_ACCOUNT_EXPIRES,
-        ATTRIBUTE_LAST_LOGON,
-        ATTRIBUTE_LAST_LOGON_TIMESTAMP,
-        ATTRIBUTE_PWD_LAST_SET,
-        ATTRIBUTE_LOCKOUT_TIME,
-        ATTRIBUTE_BAD_PWD_TIME,
-    };
-    static const QList<QString> timespans = {
-        ATTRIBUTE_MAX_PWD_AGE,
-        ATTRIBUTE_MIN_PWD_AGE,
-        ATTRIBUTE_LOCKOUT_DURATION,
-    };
+    return get_attribute_large_integer_subtype(AdAtom::find(attribute));
+}
 
-    if (datetimes.contains(attribute)) {
-        return LargeIntegerSubtype_Datetime;
-    } else if (timespans.contains(attribute)) {
-        return LargeIntegerSubtype_Timespan;
-    } else {
-        return LargeIntegerSubtype_Integer;
-    }
+LargeIntegerSubtype AdConfig::get_attribute_large_integer_subtype(const AdAtom &attribute) const {
+    return d->attribute_descriptor(attribute).large_integer_subtype;
 }
 
 bool AdConfig::get_attribute_is_number(const QString &attribute) const {
+    return get_attribute_is_number(AdAtom::find(attribute));
+}
+
+bool AdConfig::get_attribute_is_number(const AdAtom &attribute) const {
     static const QList<AttributeType> number_types = {
         AttributeType_Integer,
         AttributeType_LargeInteger,
@@ -595,31 +1052,43 @@ bool AdConfig::get_attribute_is_number(const QString &attribute) const {
 }
 
 bool AdConfig::get_attribute_is_single_valued(const QString &attribute) const {
-    return d->attribute_schemas[attribute].get_bool(ATTRIBUTE_IS_SINGLE_VALUED);
+    return get_attribute_is_single_valued(AdAtom::find(attribute));
+}
+
+bool AdConfig::get_attribute_is_single_valued(const AdAtom &attribute) const {
+    return d->attribute_descriptor(attribute).is_single_valued;
 }
 
 bool AdConfig::get_attribute_is_system_only(const QString &attribute) const {
-    return d->attribute_schemas[attribute].get_bool(ATTRIBUTE_SYSTEM_ONLY);
+    return get_attribute_is_system_only(AdAtom::find(attribute));
+}
+
+bool AdConfig::get_attribute_is_system_only(const AdAtom &attribute) const {
+    return d->attribute_descriptor(attribute).is_system_only;
 }
 
 int AdConfig::get_attribute_range_upper(const QString &attribute) const {
-    return d->attribute_schemas[attribute].get_int(ATTRIBUTE_RANGE_UPPER);
+    return get_attribute_range_upper(AdAtom::find(attribute));
+}
+
+int AdConfig::get_attribute_range_upper(const AdAtom &attribute) const {
+    return d->attribute_descriptor(attribute).range_upper;
 }
 
 bool AdConfig::get_attribute_is_backlink(const QString &attribute) const {
-    if (d->attribute_schemas[attribute].contains(ATTRIBUTE_LINK_ID)) {
-        const int link_id = d->attribute_schemas[attribute].get_int(ATTRIBUTE_LINK_ID);
-        const bool link_id_is_odd = (link_id % 2 != 0);
+    return get_attribute_is_backlink(AdAtom::find(attribute));
+}
 
-        return link_id_is_odd;
-    } else {
-        return false;
-    }
+bool AdConfig::get_attribute_is_backlink(const AdAtom &attribute) const {
+    return d->attribute_descriptor(attribute).is_backlink;
 }
 
 bool AdConfig::get_attribute_is_constructed(const QString &attribute) const {
-    const int system_flags = d->attribute_schemas[attribute].get_int(ATTRIBUTE_SYSTEM_FLAGS);
-    return bitmask_is_set(system_flags, FLAG_ATTR_IS_CONSTRUCTED);
+    return get_attribute_is_constructed(AdAtom::find(attribute));
+}
+
+bool AdConfig::get_attribute_is_constructed(const AdAtom &attribute) const {
+    return d->attribute_descriptor(attribute).is_constructed;
 }
 
 QByteArray AdConfig::get_right_guid(const QString &right_cn) const {
@@ -797,7 +1266,7 @@ QList<QString> AdConfigPrivate::add_auxiliary_classes(const QList<QString> &obje
     out += object_classes;
 
     for (const auto &object_class : object_classes) {
-        const AdObject schema = class_schemas[object_class];
+        const AdObject schema = class_schemas.value(AdAtom::find(object_class));
         out += schema.get_strings(ATTRIBUTE_AUXILIARY_CLASS);
         out += schema.get_strings(ATTRIBUTE_SYSTEM_AUXILIARY_CLASS);
     }
@@ -31,6 +31,7 @@
 
 #include <QLocale>
 
+class AdAtom;
 class AdConfigPrivate;
 class AdInterface;
 class QLocale;
@@ -52,6 +53,12 @@ public:
 
     void load(AdInterface &ad, const QLocale &locale);
 
+    // Attribute display names are loaded by load() for
+    // container and filter classes. Getters don't search,
+    // so use this to load display names of other classes,
+    // in one search, before they are needed.
+    void load_display_specifiers(AdInterface &ad, const QList<ObjectClass> &class_list);
+
     QString domain() const;
     QString domain_dn() const;
     QString configuration_dn() const;
@@ -61,12 +68,18 @@ public:
     QString policies_dn() const;
     bool control_is_supported(const QString &control_oid) const;
 
+    // NOTE: getters that accept atoms are faster than the
+    // ones that accept strings, use them in hot paths
+
     QString get_attribute_display_name(const Attribute &attribute, const ObjectClass &objectClass) const;
+    QString get_attribute_display_name(const AdAtom &attribute, const AdAtom &objectClass) const;
 
     QString get_class_display_name(const ObjectClass &objectClass) const;
+    QString get_class_display_name(const AdAtom &objectClass) const;
 
     QList<Attribute> get_columns() const;
     QString get_column_display_name(const Attribute &attribute) const;
+    QString get_column_display_name(const AdAtom &attribute) const;
     int get_column_index(const QString &attribute) const;
 
     QList<ObjectClass> get_filter_containers() const;
@@ -82,13 +95,21 @@ public:
     QList<Attribute> get_find_attributes(const ObjectClass &object_class) const;
 
     AttributeType get_attribute_type(const Attribute &attribute) const;
+    AttributeType get_attribute_type(const AdAtom &attribute) const;
     LargeIntegerSubtype get_attribute_large_integer_subtype(const Attribute &attribute) const;
+    LargeIntegerSubtype get_attribute_large_integer_subtype(const AdAtom &attribute) const;
     bool get_attribute_is_number(const Attribute &attribute) const;
+    bool get_attribute_is_number(const AdAtom &attribute) const;
     bool get_attribute_is_single_valued(const Attribute &attribute) const;
+    bool get_attribute_is_single_valued(const AdAtom &attribute) const;
     bool get_attribute_is_system_only(const Attribute &attribute) const;
+    bool get_attribute_is_system_only(const AdAtom &attribute) const;
     int get_attribute_range_upper(const Attribute &attribute) const;
+    int get_attribute_range_upper(const AdAtom &attribute) const;
     bool get_attribute_is_backlink(const Attribute &attribute) const;
+    bool get_attribute_is_backlink(const AdAtom &attribute) const;
     bool get_attribute_is_constructed(const Attribute &attribute) const;
+    bool get_attribute_is_constructed(const AdAtom &attribute) const;
 
     // Limit's edit's max valid input length based on
     // the upper range defined for attribute in schema
@@ -21,17 +21,63 @@
 #ifndef AD_CONFIG_P_H
 #define AD_CONFIG_P_H
 
+#include "ad_atom.h"
 #include "ad_object.h"
 
 #include <QByteArray>
+#include <QDateTime>
 #include <QHash>
 #include <QList>
+#include <QMutex>
 #include <QString>
+#include <QVector>
 
 // NOTE: name strings to reduce confusion
 typedef QString ObjectClass;
 typedef QString Attribute;
 
+class AdConfig;
+class AdInterface;
+
+// Raw search results from which AdConfig data is
+// processed. These are also what's stored in the disk
+// cache, so that cached and fetched data go through the
+// same processing.
+class AdConfigSearchResults {
+public:
+    QList<AdObject> attribute_schemas;
+    QList<AdObject> class_schemas;
+    QList<AdObject> display_specifiers;
+    AdObject default_display;
+    AdObject ui_settings;
+    QList<AdObject> extended_rights;
+};
+
+// Attribute display names of one class, parsed from
+// it's display specifier
+class AdDisplaySpecifier {
+public:
+    QHash<AdAtom, QString> attribute_display_names;
+    QList<Attribute> find_attributes;
+};
+
+// Schema properties of one attribute. Descriptors are
+// compiled from attribute schemas once, when config is
+// loaded, so that attribute queries don't have to parse
+// schema values. Default descriptor describes an
+// attribute which is not in the schema.
+class AdAttributeDescriptor {
+public:
+    AttributeType type = AttributeType_StringCase;
+    LargeIntegerSubtype large_integer_subtype = LargeIntegerSubtype_Integer;
+    bool is_single_valued = false;
+    bool is_system_only = false;
+    bool is_backlink = false;
+    bool is_constructed = false;
+    int range_upper = 0;
+    int link_id = 0;
+};
+
 class AdConfigPrivate {
 
 public:
@@ -45,16 +91,43 @@ public:
     QList<ObjectClass> filter_containers;
 
     QList<Attribute> columns;
-    QHash<Attribute, QString> column_display_names;
+    QHash<AdAtom, QString> column_display_names;
+
+    // NOTE: maps of attributes and classes are keyed by
+    // atoms to avoid hashing strings on every lookup
+    QHash<AdAtom, QString> class_display_names;
+
+    // NOTE: display specifiers are loaded in batches,
+    // during load() and by
+    // AdConfig::load_display_specifiers(). Getters never
+    // search. Mutex only guards the map and retry time,
+    // searches are done without holding it. After a failed
+    // search, loading is not retried until retry time.
+    QString locale_dir;
+    QMutex display_specifier_mutex;
+    QHash<AdAtom, AdDisplaySpecifier> display_specifiers;
+    QDateTime display_specifier_retry_time;
+
+    // NOTE: attribute descriptors are indexed by atom id.
+    // Table is read-only after load, so it can be used
+    // from multiple threads. Atoms interned after load
+    // are out of range and get default descriptor.
+    QVector<AdAttributeDescriptor> attribute_descriptors;
+    QHash<AdAtom, AdObject> class_schemas;
 
-    QHash<ObjectClass, QString> class_display_names;
-    QHash<ObjectClass, QList<Attribute>> find_attributes;
-    QHash<ObjectClass, QHash<Attribute, QString>> attribute_display_names;
+    QList<ObjectClass> add_auxiliary_classes(const QList<QString> &object_classes) const;
 
-    QHash<Attribute, AdObject> attribute_schemas;
-    QHash<ObjectClass, AdObject> class_schemas;
+    void fetch(AdInterface &ad, const QString &locale_dir, const bool fetch_schema, AdConfigSearchResults *out);
+    void process(const AdConfigSearchResults &results, const AdConfig *adconfig);
+    void attribute_descriptors_load(const QList<AdObject> &attribute_schemas);
+    const AdAttributeDescriptor &attribute_descriptor(const AdAtom &attribute) const;
+    static QList<QString> get_filter_container_categories(const AdObject &ui_settings);
+    static QString display_specifier_dn_to_class(const QString &dn);
+    bool display_specifier_load(AdInterface &ad, const QList<AdAtom> &class_list);
+    AdDisplaySpecifier display_specifier_get(const AdAtom &object_class);
 
-    QList<ObjectClass> add_auxiliary_classes(const QList<QString> &object_classes) const;
+    bool cache_read(const QString &path, const QString &key, AdConfigSearchResults *out);
+    void cache_write(const QString &path, const QString &key, const AdConfigSearchResults &results);
 
     QHash<QString, QByteArray> right_to_guid_map;
     QHash<QByteArray, QString> right_guid_to_cn_map;
@@ -69,7 +142,7 @@ public:
 
     QList<QString> supported_control_list;
 
-    QHash<QString, QString> sub_class_of_map;
+    QHash<AdAtom, QString> sub_class_of_map;
 };
 
 #endif /* AD_CONFIG_P_H */
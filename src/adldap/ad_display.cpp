@@ -20,6 +20,7 @@
 
 #include "ad_display.h"
 
+#include "ad_atom.h"
 #include "ad_config.h"
 #include "ad_defines.h"
 #include "ad_utils.h"
@@ -52,17 +53,31 @@ QString attribute_display_value(const QString &attribute, const QByteArray &valu
         return value;
     }
 
+    return attribute_display_value(AdAtom::find(attribute), value, adconfig);
+}
+
+QString attribute_display_value(const AdAtom &attribute, const QByteArray &value, const AdConfig *adconfig) {
+    if (adconfig == nullptr) {
+        return value;
+    }
+
+    static const AdAtom atom_user_account_control = AdAtom::intern(ATTRIBUTE_USER_ACCOUNT_CONTROL);
+    static const AdAtom atom_sam_account_type = AdAtom::intern(ATTRIBUTE_SAM_ACCOUNT_TYPE);
+    static const AdAtom atom_primary_group_id = AdAtom::intern(ATTRIBUTE_PRIMARY_GROUP_ID);
+    static const AdAtom atom_group_type = AdAtom::intern(ATTRIBUTE_GROUP_TYPE);
+    static const AdAtom atom_object_guid = AdAtom::intern(ATTRIBUTE_OBJECT_GUID);
+
     const AttributeType type = adconfig->get_attribute_type(attribute);
 
     switch (type) {
         case AttributeType_Integer: {
-            if (attribute == ATTRIBUTE_USER_ACCOUNT_CONTROL) {
+            if (attribute == atom_user_account_control) {
                 return uac_to_display_value(value);
-            } else if (attribute == ATTRIBUTE_SAM_ACCOUNT_TYPE) {
+            } else if (attribute == atom_sam_account_type) {
                 return samaccounttype_to_display_value(value);
-            } else if (attribute == ATTRIBUTE_PRIMARY_GROUP_ID) {
+            } else if (attribute == atom_primary_group_id) {
                 return primarygrouptype_to_display_value(value);
-            } else if (attribute == ATTRIBUTE_GROUP_TYPE) {
+            } else if (attribute == atom_group_type) {
                 return grouptype_to_display_value(value);
             } else {
                 return QString(value);
@@ -72,18 +87,18 @@ QString attribute_display_value(const QString &attribute, const QByteArray &valu
             const LargeIntegerSubtype subtype = adconfig->get_attribute_large_integer_subtype(attribute);
 
             switch (subtype) {
-                case LargeIntegerSubtype_Datetime: return large_integer_datetime_display_value(attribute, value, adconfig);
+                case LargeIntegerSubtype_Datetime: return large_integer_datetime_display_value(attribute.name(), value, adconfig);
                 case LargeIntegerSubtype_Timespan: return timespan_display_value(value);
                 case LargeIntegerSubtype_Integer: return QString(value);
             }
 
             return QString();
         }
-        case AttributeType_UTCTime: return datetime_display_value(attribute, value, adconfig);
-        case AttributeType_GeneralizedTime: return datetime_display_value(attribute, value, adconfig);
+        case AttributeType_UTCTime: return datetime_display_value(attribute.name(), value, adconfig);
+        case AttributeType_GeneralizedTime: return datetime_display_value(attribute.name(), value, adconfig);
         case AttributeType_Sid: return object_sid_display_value(value);
         case AttributeType_Octet: {
-            if (attribute == ATTRIBUTE_OBJECT_GUID) {
+            if (attribute == atom_object_guid) {
                 return guid_to_display_value(value);
             } else {
                 return octet_display_value(value);
@@ -99,6 +114,10 @@ QString attribute_display_value(const QString &attribute, const QByteArray &valu
 }
 
 QString attribute_display_values(const QString &attribute, const QList<QByteArray> &values, const AdConfig *adconfig) {
+    return attribute_display_values(AdAtom::find(attribute), values, adconfig);
+}
+
+QString attribute_display_values(const AdAtom &attribute, const QList<QByteArray> &values, const AdConfig *adconfig) {
     if (values.isEmpty()) {
         return QCoreApplication::translate("attribute_display", "<unset>");
     } else {
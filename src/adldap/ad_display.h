@@ -26,6 +26,7 @@
  * is given, then raw attribute values are returned.
  */
 
+class AdAtom;
 class AdConfig;
 class QString;
 class QByteArray;
@@ -33,7 +34,9 @@ template <typename T>
 class QList;
 
 QString attribute_display_value(const QString &attribute, const QByteArray &value, const AdConfig *adconfig);
+QString attribute_display_value(const AdAtom &attribute, const QByteArray &value, const AdConfig *adconfig);
 QString attribute_display_values(const QString &attribute, const QList<QByteArray> &values, const AdConfig *adconfig);
+QString attribute_display_values(const AdAtom &attribute, const QList<QByteArray> &values, const AdConfig *adconfig);
 QString object_sid_display_value(const QByteArray &sid_bytes);
 bool attribute_value_is_hex_displayed(const QString &attribute);
 
@@ -98,6 +98,15 @@ QString filter_OR(const QList<QString> &subfilters_raw) {
     }
 }
 
+// x => (!(x))
+QString filter_NOT(const QString &subfilter) {
+    if (subfilter.isEmpty()) {
+        return QString();
+    }
+
+    return QString("(!%1)").arg(subfilter);
+}
+
 QString condition_to_display_string(const Condition condition) {
     switch (condition) {
         case Condition_Equals: return QCoreApplication::translate("filter", "Is (exactly)");
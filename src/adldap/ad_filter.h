@@ -46,6 +46,9 @@ QString filter_CONDITION(const Condition condition, const QString &attribute, co
 QString filter_AND(const QList<QString> &subfilters);
 QString filter_OR(const QList<QString> &subfilters);
 
+// If argument for NOT is empty, empty string is returned
+QString filter_NOT(const QString &subfilter);
+
 // Adds advanced view filter, depending on current advanced
 // view setting
 QString add_advanced_view_filter(const QString &filter);
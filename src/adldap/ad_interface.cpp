@@ -24,6 +24,7 @@
 #include "ad_config.h"
 #include "ad_display.h"
 #include "ad_object.h"
+#include "ad_object_p.h"
 #include "ad_security.h"
 #include "ad_utils.h"
 #include "gplink.h"
@@ -35,6 +36,7 @@
 
 #include "ad_filter.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -47,10 +49,17 @@
 #include <sasl/sasl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <thread>
 #include <uuid/uuid.h>
+#include <vector>
 
+#include <QAtomicInt>
+#include <QDateTime>
 #include <QDebug>
+#include <QSharedPointer>
 #include <QTextCodec>
+#include <QThread>
+#include <QVector>
 
 // NOTE: LDAP library char* inputs are non-const in the API
 // but are const for practical purposes so we use forced
@@ -67,6 +76,38 @@
 #define MAX_DN_LENGTH 1024
 #define MAX_PASSWORD_LENGTH 255
 
+#define SEARCH_PAGE_SIZE 100
+// Max number of searches that search_concurrent() keeps
+// in flight on one connection
+#define SEARCH_CONCURRENT_MAX 8
+// How often cancel flag is checked while waiting for
+// search results
+#define SEARCH_CANCEL_POLL_INTERVAL_MS 100
+
+// Max number of modify operations that modify_batch()
+// keeps in flight on one connection
+#define MODIFY_BATCH_MAX 16
+
+// How long object_delete_list() waits for next reply
+// before giving up on deletes that are still in flight.
+// NOTE: this is generous because tree deletes of big
+// containers can take a while.
+#define DELETE_LIST_REPLY_TIMEOUT_SECS 300
+
+// Max number of threads (and SMB contexts) used to walk
+// GPT contents
+#define GPT_WALK_THREADS_MAX 4
+
+// Max number of idle connections kept in the pool
+#define POOL_SIZE_MAX 8
+// Connections that were idle for longer than this are
+// checked before reuse
+#define POOL_CHECK_IDLE_MSECS (30 * 1000)
+// Connections older than this are not reused and are
+// rebound instead, so that connection doesn't outlive
+// the kerberos ticket it was bound with
+#define POOL_LIFETIME_MSECS (10 * 60 * 1000)
+
 typedef struct sasl_defaults_gssapi {
     char *mech;
     char *realm;
@@ -80,10 +121,40 @@ enum AceMaskFormat {
     AceMaskFormat_Decimal,
 };
 
-QList<QString> query_server_for_hosts(const char *dname);
+// SRV record of a domain host
+class DomainHost {
+public:
+    QString host;
+    int priority;
+    int weight;
+    int ttl;
+};
+
+class DomainHostsCacheEntry {
+public:
+    QList<QString> host_list;
+    qint64 expire_time;
+};
+
+// Holds the prefetch thread and joins it when static data
+// is destroyed at exit, so that the thread never uses the
+// cache after it's destroyed
+class DomainHostsPrefetch {
+public:
+    std::thread thread;
+
+    ~DomainHostsPrefetch();
+};
+
+QList<DomainHost> query_server_for_hosts(const char *dname);
+int search_scope_to_ldap(const SearchScope scope);
+QList<QString> query_server_for_hosts_cached(const QString &dname);
 int sasl_interact_gssapi(LDAP *ld, unsigned flags, void *indefaults, void *in);
 QString get_gpt_sd_string(const AdObject &gpc_object, const AceMaskFormat format);
 int create_sd_control(bool get_sacl, int iscritical, LDAPControl **ctrlp);
+AdGptDirListing gpt_list_dir(SMBCCTX *context, const QString &path);
+QString gpt_sd_read(SMBCCTX *context, const QString &smb_path, int *error);
+bool gpt_sd_match(const QString &gpc_sd, const QString &gpt_sd);
 
 AdConfig *AdInterfacePrivate::adconfig = nullptr;
 bool AdInterfacePrivate::s_log_searches = false;
@@ -92,7 +163,25 @@ void *AdInterfacePrivate::s_sasl_nocanon = LDAP_OPT_ON;
 int AdInterfacePrivate::s_port = 0;
 CertStrategy AdInterfacePrivate::s_cert_strat = CertStrategy_Never;
 SMBCCTX *AdInterfacePrivate::smbc = NULL;
+QMutex AdInterfacePrivate::smbc_worker_mutex;
+QList<SMBCCTX *> AdInterfacePrivate::smbc_worker_pool = QList<SMBCCTX *>();
 QMutex AdInterfacePrivate::mutex;
+QMutex AdInterfacePrivate::pool_mutex;
+QList<AdPooledConnection> AdInterfacePrivate::pool = QList<AdPooledConnection>();
+int AdInterfacePrivate::pool_generation = 0;
+
+// NOTE: DC discovery results are shared by the whole
+// process and are keyed by SRV query name. Main mutex
+// guards the cache and the map of lookup mutexes. Lookup
+// mutexes are per name and are held during the DNS query.
+QMutex domain_hosts_mutex;
+QHash<QString, DomainHostsCacheEntry> domain_hosts_cache;
+QHash<QString, QSharedPointer<QMutex>> domain_hosts_lookup_mutex_map;
+QAtomicInt domain_hosts_query_count;
+
+// NOTE: must be defined after the cache, so that it is
+// destroyed before the cache
+DomainHostsPrefetch domain_hosts_prefetch;
 
 void get_auth_data_fn(const char *pServer, const char *pShare, char *pWorkgroup, int maxLenWorkgroup, char *pUsername, int maxLenUsername, char *pPassword, int maxLenPassword) {
     UNUSED_ARG(pServer);
@@ -120,6 +209,20 @@ AdInterface::AdInterface() {
         return;
     }
 
+    // NOTE: principal is part of pool key so that after
+    // kinit as another user connections bound as the
+    // previous user are not reused
+    d->principal = get_default_principal_from_krb5();
+
+    // Reuse an already bound connection, if there is
+    // one in the pool
+    const bool took_from_pool = d->pool_take();
+    if (took_from_pool) {
+        d->is_connected = true;
+
+        return;
+    }
+
     //
     // Connect via LDAP
     //
@@ -170,7 +273,7 @@ AdInterface::AdInterface() {
     int result;
 
     // NOTE: this doesn't leak memory. False positive.
-    result = ldap_initialize(&d->ld, cstr(uri));
+    result = ldap_initialize(&d->ld, CStr(uri));
     if (result != LDAP_SUCCESS) {
         ldap_memfree(d->ld);
         d->error_message(tr("Failed to initialize LDAP library."), strerror(errno));
@@ -272,6 +375,10 @@ AdInterface::AdInterface() {
     // wouldn't be able to have multiple active
     // AdInterface's instances at the same time
     if (AdInterfacePrivate::smbc == NULL) {
+        // NOTE: needed to use separate contexts from
+        // multiple threads, see gpt_list_dirs()
+        smbc_thread_posix();
+
         smbc_init(get_auth_data_fn, 0);
         AdInterfacePrivate::smbc = smbc_new_context();
         smbc_setOptionUseKerberos(AdInterfacePrivate::smbc, true);
@@ -284,12 +391,13 @@ AdInterface::AdInterface() {
         smbc_set_context(AdInterfacePrivate::smbc);
     }
 
+    d->connect_time = QDateTime::currentMSecsSinceEpoch();
     d->is_connected = true;
 }
 
 AdInterface::~AdInterface() {
     if (d->is_connected) {
-        ldap_unbind_ext(d->ld, NULL, NULL);
+        d->pool_put();
     } else {
         ldap_memfree(d->ld);
     }
@@ -305,8 +413,13 @@ void AdInterface::set_log_searches(const bool enabled) {
     AdInterfacePrivate::s_log_searches = enabled;
 }
 
+// NOTE: connection options are applied only when
+// connecting, so pooled connections made with previous
+// options have to be dropped when options change
+
 void AdInterface::set_dc(const QString &dc) {
     AdInterfacePrivate::s_dc = dc;
+    AdInterfacePrivate::pool_clear();
 }
 
 void AdInterface::set_sasl_nocanon(const bool is_on) {
@@ -317,20 +430,139 @@ void AdInterface::set_sasl_nocanon(const bool is_on) {
             return LDAP_OPT_OFF;
         }
     }();
+    AdInterfacePrivate::pool_clear();
 }
 
 void AdInterface::set_port(const int port) {
     AdInterfacePrivate::s_port = port;
+    AdInterfacePrivate::pool_clear();
 }
 
 void AdInterface::set_cert_strategy(const CertStrategy strategy) {
     AdInterfacePrivate::s_cert_strat = strategy;
+    AdInterfacePrivate::pool_clear();
 }
 
 AdInterfacePrivate::AdInterfacePrivate(AdInterface *q_arg) {
     mutex.lock();
     q = q_arg;
     mutex.unlock();
+
+    connect_time = 0;
+    cancel_flag = nullptr;
+    has_pending_ops = false;
+}
+
+bool AdInterfacePrivate::pool_take() {
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    while (true) {
+        AdPooledConnection connection;
+        int current_generation;
+
+        {
+            QMutexLocker locker(&pool_mutex);
+
+            if (pool.isEmpty()) {
+                return false;
+            }
+
+            // NOTE: take most recently used connection,
+            // it's the least likely to be stale
+            connection = pool.takeLast();
+            current_generation = pool_generation;
+        }
+
+        const bool is_obsolete = [&]() {
+            const bool options_changed = (connection.generation != current_generation);
+            const bool domain_changed = (connection.domain != domain);
+            const bool principal_changed = (connection.principal != principal);
+            const bool too_old = (now - connection.connect_time > POOL_LIFETIME_MSECS);
+
+            return (options_changed || domain_changed || principal_changed || too_old);
+        }();
+
+        const bool is_alive = [&]() {
+            if (is_obsolete) {
+                return false;
+            }
+
+            const bool need_check = (now - connection.release_time > POOL_CHECK_IDLE_MSECS);
+            if (!need_check) {
+                return true;
+            }
+
+            // Check that server hasn't dropped the
+            // connection while it was idle, by doing a
+            // minimal rootDSE search. "1.1" requests no
+            // attributes.
+            char *attrs[] = {(char *) "1.1", NULL};
+            struct timeval timeout = {5, 0};
+            LDAPMessage *res = NULL;
+            const int result = ldap_search_ext_s(connection.ld, "", LDAP_SCOPE_BASE, "(objectClass=*)", attrs, 0, NULL, NULL, &timeout, 1, &res);
+            ldap_msgfree(res);
+
+            return (result == LDAP_SUCCESS);
+        }();
+
+        if (is_alive) {
+            ld = connection.ld;
+            dc = connection.dc;
+            client_user = connection.client_user;
+            connect_time = connection.connect_time;
+
+            return true;
+        } else {
+            ldap_unbind_ext(connection.ld, NULL, NULL);
+        }
+    }
+}
+
+void AdInterfacePrivate::pool_put() {
+    // NOTE: don't return connections that lost contact
+    // with server
+    const int ldap_result = get_ldap_result();
+    const bool connection_is_broken = (ldap_result == LDAP_SERVER_DOWN || ldap_result == LDAP_CONNECT_ERROR);
+
+    QMutexLocker locker(&pool_mutex);
+
+    const bool can_reuse = (!connection_is_broken && !has_pending_ops && pool.size() < POOL_SIZE_MAX);
+
+    if (can_reuse) {
+        AdPooledConnection connection;
+        connection.ld = ld;
+        connection.domain = domain;
+        connection.principal = principal;
+        connection.dc = dc;
+        connection.client_user = client_user;
+        connection.generation = pool_generation;
+        connection.connect_time = connect_time;
+        connection.release_time = QDateTime::currentMSecsSinceEpoch();
+
+        pool.append(connection);
+    } else {
+        locker.unlock();
+
+        ldap_unbind_ext(ld, NULL, NULL);
+    }
+
+    ld = NULL;
+}
+
+void AdInterfacePrivate::pool_clear() {
+    const QList<AdPooledConnection> pool_copy = [&]() {
+        QMutexLocker locker(&pool_mutex);
+
+        const QList<AdPooledConnection> out = pool;
+        pool.clear();
+        pool_generation++;
+
+        return out;
+    }();
+
+    for (const AdPooledConnection &connection : pool_copy) {
+        ldap_unbind_ext(connection.ld, NULL, NULL);
+    }
 }
 
 bool AdInterface::is_connected() const {
@@ -363,27 +595,17 @@ QString AdInterface::client_user() const {
     return d->client_user;
 }
 
-// Helper f-n for search()
-// NOTE: cookie is starts as NULL. Then after each while
-// loop, it is set to the value returned by
-// ldap_search_ext_s(). At the end cookie is set back to
-// NULL.
-bool AdInterfacePrivate::search_paged_internal(const char *base, const int scope, const char *filter, char **attributes, QHash<QString, AdObject> *results, AdCookie *cookie, const bool get_sacl) {
+// Sends a request for one page of search results
+// asynchronously. Results should then be received via
+// ldap_result() using returned msgid.
+int AdInterfacePrivate::search_send(const char *base, const int scope, const char *filter, char **attributes, struct berval *cookie, const bool get_sacl, int *msgid) {
     int result;
-    LDAPMessage *res = NULL;
     LDAPControl *page_control = NULL;
     LDAPControl *sd_control = NULL;
-    LDAPControl **returned_controls = NULL;
-    struct berval *prev_cookie = cookie->cookie;
-    struct berval *new_cookie = NULL;
 
     auto cleanup = [&]() {
-        ldap_msgfree(res);
         ldap_control_free(page_control);
         ldap_control_free(sd_control);
-        ldap_controls_free(returned_controls);
-        ber_bvfree(prev_cookie);
-        ber_bvfree(new_cookie);
     };
 
     const int is_critical = 1;
@@ -393,79 +615,93 @@ bool AdInterfacePrivate::search_paged_internal(const char *base, const int scope
         qDebug() << "Failed to create sd control: " << ldap_err2string(result);
 
         cleanup();
-        return false;
+        return result;
     }
 
     // Create page control
-    const ber_int_t page_size = 100;
-    result = ldap_create_page_control(ld, page_size, prev_cookie, is_critical, &page_control);
+    const ber_int_t page_size = SEARCH_PAGE_SIZE;
+    result = ldap_create_page_control(ld, page_size, cookie, is_critical, &page_control);
     if (result != LDAP_SUCCESS) {
         qDebug() << "Failed to create page control: " << ldap_err2string(result);
 
         cleanup();
-        return false;
+        return result;
     }
     LDAPControl *server_controls[3] = {page_control, sd_control, NULL};
 
-    // Perform search
+    // Send search request
     const int attrsonly = 0;
-    result = ldap_search_ext_s(ld, base, scope, filter, attributes, attrsonly, server_controls, NULL, NULL, LDAP_NO_LIMIT, &res);
+    result = ldap_search_ext(ld, base, scope, filter, attributes, attrsonly, server_controls, NULL, NULL, LDAP_NO_LIMIT, msgid);
+    if (result != LDAP_SUCCESS) {
+        qDebug() << "Error in ldap_search_ext: " << ldap_err2string(result);
+    }
 
-    if ((result != LDAP_SUCCESS) && (result != LDAP_PARTIAL_RESULTS)) {
-        // NOTE: it's not really an error for an object to
-        // not exist. For example, sometimes it's needed to
-        // check whether an object exists. Not sure how to
-        // distinguish this error type from others
-        if (result != LDAP_NO_SUCH_OBJECT) {
-            qDebug() << "Error in paged ldap_search_ext_s: " << ldap_err2string(result);
-        }
+    cleanup();
+    return result;
+}
 
-        cleanup();
-        return false;
-    }
+// Loads object from an LDAP_RES_SEARCH_ENTRY message
+// into builder
+// NOTE: values are read directly from the message buffer
+// using ldap_get_attribute_ber(), instead of
+// ldap_get_values_len() which makes a copy of each value,
+// so values are copied only once, into the builder's arena
+void AdInterfacePrivate::search_load_entry(LDAPMessage *entry, AdObjectBuilder *builder) {
+    BerElement *ber = NULL;
+    struct berval dn_bv;
 
-    // Collect results for this search
-    for (LDAPMessage *entry = ldap_first_entry(ld, res); entry != NULL; entry = ldap_next_entry(ld, entry)) {
-        char *dn_cstr = ldap_get_dn(ld, entry);
-        const QString dn(dn_cstr);
-        ldap_memfree(dn_cstr);
+    const int dn_result = ldap_get_dn_ber(ld, entry, &ber, &dn_bv);
+    if (dn_result != LDAP_SUCCESS) {
+        qDebug() << "Failed to get entry dn: " << ldap_err2string(dn_result);
 
-        QHash<QString, QList<QByteArray>> object_attributes;
+        ber_free(ber, 0);
 
-        BerElement *berptr;
-        for (char *attr = ldap_first_attribute(ld, entry, &berptr); attr != NULL; attr = ldap_next_attribute(ld, entry, berptr)) {
-            struct berval **values_ldap = ldap_get_values_len(ld, entry, attr);
+        return;
+    }
 
-            const QList<QByteArray> values_bytes = [=]() {
-                QList<QByteArray> out;
+    const QString dn = QString::fromUtf8(dn_bv.bv_val, dn_bv.bv_len);
 
-                if (values_ldap != NULL) {
-                    const int values_count = ldap_count_values_len(values_ldap);
-                    for (int i = 0; i < values_count; i++) {
-                        struct berval value_berval = *values_ldap[i];
-                        const QByteArray value_bytes(value_berval.bv_val, value_berval.bv_len);
+    builder->begin_object(dn);
 
-                        out.append(value_bytes);
-                    }
-                }
+    while (true) {
+        struct berval attr_bv;
+        struct berval *values_bv = NULL;
 
-                return out;
-            }();
+        const int attr_result = ldap_get_attribute_ber(ld, entry, ber, &attr_bv, &values_bv);
+        if (attr_result != LDAP_SUCCESS || attr_bv.bv_val == NULL) {
+            break;
+        }
 
-            const QString attribute(attr);
+        builder->add_attribute(attr_bv.bv_val, attr_bv.bv_len);
 
-            object_attributes[attribute] = values_bytes;
+        if (values_bv != NULL) {
+            for (int i = 0; values_bv[i].bv_val != NULL; i++) {
+                builder->add_value(values_bv[i].bv_val, values_bv[i].bv_len);
+            }
 
-            ldap_value_free_len(values_ldap);
-            ldap_memfree(attr);
+            ber_memfree(values_bv);
         }
-        ber_free(berptr, 0);
+    }
 
-        AdObject object;
-        object.load(dn, object_attributes);
+    builder->end_object();
 
-        results->insert(dn, object);
-    }
+    ber_free(ber, 0);
+}
+
+// Parses the final LDAP_RES_SEARCH_RESULT message of a
+// search page. If there are more pages, new_cookie is set
+// to the cookie for next page, otherwise it's set to NULL.
+bool AdInterfacePrivate::search_parse_result(LDAPMessage *res, struct berval **new_cookie) {
+    int result;
+    LDAPControl **returned_controls = NULL;
+    struct berval *pageresponse_cookie = NULL;
+
+    *new_cookie = NULL;
+
+    auto cleanup = [&]() {
+        ldap_controls_free(returned_controls);
+        ber_bvfree(pageresponse_cookie);
+    };
 
     // Parse the results to retrieve returned controls
     int errcodep;
@@ -477,6 +713,19 @@ bool AdInterfacePrivate::search_paged_internal(const char *base, const int scope
         return false;
     }
 
+    if ((errcodep != LDAP_SUCCESS) && (errcodep != LDAP_PARTIAL_RESULTS)) {
+        // NOTE: it's not really an error for an object to
+        // not exist. For example, sometimes it's needed to
+        // check whether an object exists. Not sure how to
+        // distinguish this error type from others
+        if (errcodep != LDAP_NO_SUCH_OBJECT) {
+            qDebug() << "Error in paged search: " << ldap_err2string(errcodep);
+        }
+
+        cleanup();
+        return false;
+    }
+
     // Get page response control
     //
     // NOTE: not sure if absence of page response control is
@@ -487,8 +736,8 @@ bool AdInterfacePrivate::search_paged_internal(const char *base, const int scope
         // Parse page response control to determine whether
         // there are more pages
         ber_int_t total_count;
-        new_cookie = (struct berval *) malloc(sizeof(struct berval));
-        result = ldap_parse_pageresponse_control(ld, pageresponse_control, &total_count, new_cookie);
+        pageresponse_cookie = (struct berval *) calloc(1, sizeof(struct berval));
+        result = ldap_parse_pageresponse_control(ld, pageresponse_control, &total_count, pageresponse_cookie);
         if (result != LDAP_SUCCESS) {
             qDebug() << "Failed to parse pageresponse control: " << ldap_err2string(result);
 
@@ -499,20 +748,136 @@ bool AdInterfacePrivate::search_paged_internal(const char *base, const int scope
         // Switch to new cookie if there are more pages
         // NOTE: there are more pages if the cookie isn't
         // empty
-        const bool more_pages = (new_cookie->bv_len > 0);
+        const bool more_pages = (pageresponse_cookie->bv_len > 0);
         if (more_pages) {
-            cookie->cookie = ber_bvdup(new_cookie);
-        } else {
-            cookie->cookie = NULL;
+            *new_cookie = ber_bvdup(pageresponse_cookie);
         }
-    } else {
-        cookie->cookie = NULL;
     }
 
     cleanup();
     return true;
 }
 
+// Helper f-n for search()
+// NOTE: cookie is starts as NULL. Then after each call, it
+// is set to the value returned by the server. At the end
+// cookie is set back to NULL.
+// NOTE: entries are loaded one by one as they arrive from
+// the server instead of waiting for the whole page, so
+// that processing overlaps with network transfer.
+bool AdInterfacePrivate::search_paged_internal(const char *base, const int scope, const char *filter, char **attributes, QHash<QString, AdObject> *results, AdCookie *cookie, const bool get_sacl) {
+    struct berval *prev_cookie = cookie->cookie;
+    cookie->cookie = NULL;
+
+    int msgid;
+    const int send_result = search_send(base, scope, filter, attributes, prev_cookie, get_sacl, &msgid);
+    ber_bvfree(prev_cookie);
+
+    if (send_result != LDAP_SUCCESS) {
+        return false;
+    }
+
+    AdObjectBuilder builder;
+
+    LDAPMessage *res = search_receive(msgid, &builder);
+    if (res == NULL) {
+        return false;
+    }
+
+    const bool success = search_parse_result(res, &cookie->cookie);
+    ldap_msgfree(res);
+
+    if (success) {
+        builder.finish(results);
+    }
+
+    return success;
+}
+
+// Receives entries of a search one by one and loads them
+// into builder. Returns the final result message, which
+// should be parsed and then freed by caller. Returns NULL
+// on failure.
+LDAPMessage *AdInterfacePrivate::search_receive(const int msgid, AdObjectBuilder *builder) {
+    // NOTE: if search can be cancelled, wait for results
+    // with a timeout so that cancel flag is checked even
+    // if server is slow to respond
+    struct timeval cancel_poll_timeout;
+    cancel_poll_timeout.tv_sec = 0;
+    cancel_poll_timeout.tv_usec = SEARCH_CANCEL_POLL_INTERVAL_MS * 1000;
+    struct timeval *timeout = (cancel_flag != nullptr ? &cancel_poll_timeout : NULL);
+
+    while (true) {
+        // NOTE: abandon tells server to stop sending
+        // results and discards results that already
+        // arrived
+        if (is_cancelled()) {
+            ldap_abandon_ext(ld, msgid, NULL, NULL);
+            has_pending_ops = true;
+
+            return NULL;
+        }
+
+        LDAPMessage *msg = NULL;
+        const int msg_type = ldap_result(ld, msgid, LDAP_MSG_ONE, timeout, &msg);
+
+        // NOTE: ldap_result() modifies timeout on some
+        // platforms, so restore it
+        cancel_poll_timeout.tv_sec = 0;
+        cancel_poll_timeout.tv_usec = SEARCH_CANCEL_POLL_INTERVAL_MS * 1000;
+
+        switch (msg_type) {
+            case 0: {
+                // Timed out, check cancel flag again
+                break;
+            }
+            case LDAP_RES_SEARCH_ENTRY: {
+                search_load_entry(msg, builder);
+
+                break;
+            }
+            case LDAP_RES_SEARCH_REFERENCE: {
+                break;
+            }
+            case LDAP_RES_SEARCH_RESULT: {
+                return msg;
+            }
+            default: {
+                qDebug() << "Failed to get search result: " << ldap_err2string(get_ldap_result());
+
+                ldap_msgfree(msg);
+                ldap_abandon_ext(ld, msgid, NULL, NULL);
+                has_pending_ops = true;
+
+                return NULL;
+            }
+        }
+
+        ldap_msgfree(msg);
+    }
+}
+
+bool AdInterfacePrivate::is_cancelled() const {
+    return (cancel_flag != nullptr && cancel_flag->loadAcquire() != 0);
+}
+
+void AdInterfacePrivate::search_log(const QString &base, const SearchScope scope, const QString &filter, const QList<QString> &attributes) {
+    const QString attributes_string = "{" + attributes.join(",") + "}";
+
+    const QString scope_string = [&scope]() -> QString {
+        switch (scope) {
+            case SearchScope_Object: return "object";
+            case SearchScope_Children: return "children";
+            case SearchScope_Descendants: return "descendants";
+            case SearchScope_All: return "all";
+            default: break;
+        }
+        return QString();
+    }();
+
+    success_message(QString(tr("Search:\n\tfilter = \"%1\"\n\tattributes = %2\n\tscope = \"%3\"\n\tbase = \"%4\"")).arg(filter, attributes_string, scope_string, base));
+}
+
 QHash<QString, AdObject> AdInterface::search(const QString &base, const SearchScope scope, const QString &filter, const QList<QString> &attributes, const bool get_sacl) {
     AdCookie cookie;
     QHash<QString, AdObject> results;
@@ -538,43 +903,17 @@ bool AdInterface::search_paged(const QString &base, const SearchScope scope, con
     const bool is_first_page = results->isEmpty();
     const bool need_to_log = (AdInterfacePrivate::s_log_searches && is_first_page);
     if (need_to_log) {
-        const QString attributes_string = "{" + attributes.join(",") + "}";
-
-        const QString scope_string = [&scope]() -> QString {
-            switch (scope) {
-                case SearchScope_Object: return "object";
-                case SearchScope_Children: return "children";
-                case SearchScope_Descendants: return "descendants";
-                case SearchScope_All: return "all";
-                default: break;
-            }
-            return QString();
-        }();
-
-        d->success_message(QString(tr("Search:\n\tfilter = \"%1\"\n\tattributes = %2\n\tscope = \"%3\"\n\tbase = \"%4\"")).arg(filter, attributes_string, scope_string, base));
+        d->search_log(base, scope, filter, attributes);
     }
 
-    const char *base_cstr = cstr(base);
+    const CStr base_cstr(base);
 
-    const int scope_int = [&]() {
-        switch (scope) {
-            case SearchScope_Object: return LDAP_SCOPE_BASE;
-            case SearchScope_Children: return LDAP_SCOPE_ONELEVEL;
-            case SearchScope_All: return LDAP_SCOPE_SUBTREE;
-            case SearchScope_Descendants: return LDAP_SCOPE_CHILDREN;
-        }
-        return 0;
-    }();
+    const int scope_int = search_scope_to_ldap(scope);
 
-    const char *filter_cstr = [&]() {
-        if (filter.isEmpty()) {
-            // NOTE: need to pass NULL instead of empty
-            // string to denote "no filter"
-            return (const char *) NULL;
-        } else {
-            return cstr(filter);
-        }
-    }();
+    // NOTE: need to pass NULL instead of empty string to
+    // denote "no filter"
+    const CStr filter_cstr_buffer(filter);
+    const char *filter_cstr = (filter.isEmpty() ? NULL : filter_cstr_buffer.get());
 
     // Convert attributes list to NULL-terminated array
     char **attributes_array = [&]() {
@@ -588,7 +927,7 @@ bool AdInterface::search_paged(const QString &base, const SearchScope scope, con
             if (out != NULL) {
                 for (int i = 0; i < attributes.size(); i++) {
                     const QString attribute = attributes[i];
-                    out[i] = strdup(cstr(attribute));
+                    out[i] = strdup(CStr(attribute));
                 }
                 out[attributes.size()] = NULL;
             }
@@ -598,11 +937,6 @@ bool AdInterface::search_paged(const QString &base, const SearchScope scope, con
     }();
 
     const bool search_success = d->search_paged_internal(base_cstr, scope_int, filter_cstr, attributes_array, results, cookie, get_sacl);
-    if (!search_success) {
-        results->clear();
-
-        return false;
-    }
 
     if (attributes_array != NULL) {
         for (int i = 0; attributes_array[i] != NULL; i++) {
@@ -611,174 +945,835 @@ bool AdInterface::search_paged(const QString &base, const SearchScope scope, con
         free(attributes_array);
     }
 
+    if (!search_success) {
+        results->clear();
+
+        return false;
+    }
+
     return true;
 }
 
-AdObject AdInterface::search_object(const QString &dn, const QList<QString> &attributes, const bool get_sacl) {
-    const QString base = dn;
-    const SearchScope scope = SearchScope_Object;
-    const QString filter = QString();
-    const QHash<QString, AdObject> results = search(base, scope, filter, attributes, get_sacl);
+// State of one search in search_concurrent()
+class AdSearchOp {
+public:
+    QByteArray base;
+    QByteArray filter;
+    QList<QByteArray> attributes;
+    QVector<char *> attributes_array;
+    int scope;
+    bool get_sacl;
+    struct berval *cookie;
+    int msgid;
+    bool failed;
+    AdObjectBuilder builder;
+    QHash<QString, AdObject> results;
+};
 
-    if (results.contains(dn)) {
-        return results[dn];
-    } else {
-        return AdObject();
-    }
-}
+QList<QHash<QString, AdObject>> AdInterface::search_concurrent(const QList<AdSearchArgs> &args_list) {
+    // NOTE: using vector instead of QList so that ops
+    // stay in place, because attributes_array points to
+    // attribute strings stored in the op
+    std::vector<AdSearchOp> op_list(args_list.size());
 
-bool AdInterface::attribute_replace_values(const QString &dn, const QString &attribute, const QList<QByteArray> &values, const DoStatusMsg do_msg) {
-    const AdObject object = search_object(dn, {attribute});
-    const QList<QByteArray> old_values = object.get_values(attribute);
-    const QString name = dn_get_name(dn);
-    const QString values_display = attribute_display_values(attribute, values, d->adconfig);
-    const QString old_values_display = attribute_display_values(attribute, old_values, d->adconfig);
+    for (int i = 0; i < args_list.size(); i++) {
+        const AdSearchArgs &args = args_list[i];
+        AdSearchOp &op = op_list[i];
 
-    // Do nothing if both new and old values are empty
-    if (old_values.isEmpty() && values.isEmpty()) {
-        return true;
+        if (AdInterfacePrivate::s_log_searches) {
+            d->search_log(args.base, args.scope, args.filter, args.attributes);
+        }
+
+        op.base = args.base.toUtf8();
+        op.filter = args.filter.toUtf8();
+        for (const QString &attribute : args.attributes) {
+            op.attributes.append(attribute.toUtf8());
+        }
+        // NOTE: empty array means "all attributes" and is
+        // passed as NULL
+        if (!op.attributes.isEmpty()) {
+            for (const QByteArray &attribute : op.attributes) {
+                op.attributes_array.append((char *) attribute.constData());
+            }
+            op.attributes_array.append(NULL);
+        }
+        op.scope = search_scope_to_ldap(args.scope);
+        op.get_sacl = args.get_sacl;
+        op.cookie = NULL;
+        op.msgid = -1;
+        op.failed = false;
     }
 
-    // NOTE: store bvalues in array instead of dynamically allocating ptrs
-    struct berval bvalues_storage[values.size()];
-    struct berval *bvalues[values.size() + 1];
-    bvalues[values.size()] = NULL;
-    for (int i = 0; i < values.size(); i++) {
-        const QByteArray value = values[i];
-        struct berval *bvalue = &(bvalues_storage[i]);
+    // Map of msgid => index of op in op_list, for ops
+    // which have a request in flight
+    QHash<int, int> outstanding;
 
-        bvalue->bv_val = (char *) value.constData();
-        bvalue->bv_len = (size_t) value.size();
+    auto send_op = [&](const int op_i) {
+        AdSearchOp &op = op_list[op_i];
 
-        bvalues[i] = bvalue;
-    }
+        const char *filter_cstr = (op.filter.isEmpty() ? NULL : op.filter.constData());
+        char **attributes_cstr = (op.attributes_array.isEmpty() ? NULL : op.attributes_array.data());
 
-    LDAPMod attr;
-    attr.mod_op = (LDAP_MOD_REPLACE | LDAP_MOD_BVALUES);
-    attr.mod_type = (char *) cstr(attribute);
-    attr.mod_bvalues = bvalues;
+        const int result = d->search_send(op.base.constData(), op.scope, filter_cstr, attributes_cstr, op.cookie, op.get_sacl, &op.msgid);
 
-    LDAPMod *attrs[] = {&attr, NULL};
+        if (result == LDAP_SUCCESS) {
+            outstanding[op.msgid] = op_i;
+        } else {
+            op.failed = true;
+        }
+    };
 
-    const int result = ldap_modify_ext_s(d->ld, cstr(dn), attrs, NULL, NULL);
+    // Send first pages of searches. Later pages are sent
+    // as soon as the previous page of that search
+    // completes.
+    int next_op_i = 0;
+    auto send_pending_ops = [&]() {
+        while (next_op_i < (int) op_list.size() && outstanding.size() < SEARCH_CONCURRENT_MAX) {
+            send_op(next_op_i);
+            next_op_i++;
+        }
+    };
 
-    if (result == LDAP_SUCCESS) {
-        d->success_message(QString(tr("Attribute %1 of object %2 was changed from \"%3\" to \"%4\".")).arg(attribute, name, old_values_display, values_display), do_msg);
+    send_pending_ops();
 
-        return true;
-    } else {
-        const QString context = QString(tr("Failed to change attribute %1 of object %2 from \"%3\" to \"%4\".")).arg(attribute, name, old_values_display, values_display);
+    while (!outstanding.isEmpty()) {
+        LDAPMessage *msg = NULL;
+        const int msg_type = ldap_result(d->ld, LDAP_RES_ANY, LDAP_MSG_ONE, NULL, &msg);
 
-        d->error_message(context, d->default_error(), do_msg);
+        const bool result_error = (msg_type == -1 || msg_type == 0);
+        if (result_error) {
+            qDebug() << "Failed to get search result: " << ldap_err2string(d->get_ldap_result());
 
-        return false;
-    }
-}
+            ldap_msgfree(msg);
 
-bool AdInterface::attribute_replace_value(const QString &dn, const QString &attribute, const QByteArray &value, const DoStatusMsg do_msg) {
-    const QList<QByteArray> values = [=]() -> QList<QByteArray> {
-        if (value.isEmpty()) {
-            return QList<QByteArray>();
-        } else {
-            return {value};
+            // Abandon all searches that are still in
+            // progress, including the ones that weren't
+            // sent yet
+            for (const int msgid : outstanding.keys()) {
+                ldap_abandon_ext(d->ld, msgid, NULL, NULL);
+                d->has_pending_ops = true;
+
+                const int op_i = outstanding[msgid];
+                op_list[op_i].failed = true;
+            }
+            outstanding.clear();
+
+            for (; next_op_i < (int) op_list.size(); next_op_i++) {
+                op_list[next_op_i].failed = true;
+            }
+
+            break;
+        }
+
+        const int msgid = ldap_msgid(msg);
+        if (!outstanding.contains(msgid)) {
+            ldap_msgfree(msg);
+
+            continue;
+        }
+
+        const int op_i = outstanding[msgid];
+        AdSearchOp &op = op_list[op_i];
+
+        switch (msg_type) {
+            case LDAP_RES_SEARCH_ENTRY: {
+                d->search_load_entry(msg, &op.builder);
+
+                break;
+            }
+            case LDAP_RES_SEARCH_RESULT: {
+                outstanding.remove(msgid);
+
+                struct berval *new_cookie = NULL;
+                const bool success = d->search_parse_result(msg, &new_cookie);
+                ber_bvfree(op.cookie);
+                op.cookie = new_cookie;
+
+                if (!success) {
+                    op.failed = true;
+                } else {
+                    op.builder.finish(&op.results);
+
+                    if (op.cookie != NULL) {
+                        send_op(op_i);
+                    }
+                }
+
+                send_pending_ops();
+
+                break;
+            }
+            default: break;
+        }
+
+        ldap_msgfree(msg);
+    }
+
+    QList<QHash<QString, AdObject>> out;
+
+    for (AdSearchOp &op : op_list) {
+        ber_bvfree(op.cookie);
+
+        // NOTE: match behavior of search(), which returns
+        // empty results on failure
+        if (op.failed) {
+            out.append(QHash<QString, AdObject>());
+        } else {
+            out.append(op.results);
+        }
+    }
+
+    return out;
+}
+
+bool AdInterface::search_vlv(const QString &base, const SearchScope scope, const QString &filter, const QList<QString> &attributes, const QString &sort_attribute, const int offset, const int count, QList<AdObject> *results, AdVlvContext *context) {
+    if (d->adconfig != nullptr) {
+        const bool controls_supported = (d->adconfig->control_is_supported(LDAP_CONTROL_SORTREQUEST) && d->adconfig->control_is_supported(LDAP_CONTROL_VLVREQUEST));
+
+        if (!controls_supported) {
+            return false;
+        }
+    }
+
+    // NOTE: only log first window
+    const bool need_to_log = (AdInterfacePrivate::s_log_searches && offset == 0);
+    if (need_to_log) {
+        d->search_log(base, scope, filter, attributes);
+    }
+
+    int result;
+    LDAPSortKey **sort_keylist = NULL;
+    LDAPControl *sort_control = NULL;
+    LDAPControl *vlv_control = NULL;
+    LDAPControl *sd_control = NULL;
+    LDAPControl **returned_controls = NULL;
+    LDAPMessage *res = NULL;
+    struct berval *new_context = NULL;
+
+    auto cleanup = [&]() {
+        ldap_free_sort_keylist(sort_keylist);
+        ldap_control_free(sort_control);
+        ldap_control_free(vlv_control);
+        ldap_control_free(sd_control);
+        ldap_controls_free(returned_controls);
+        ldap_msgfree(res);
+        ber_bvfree(new_context);
+    };
+
+    const int is_critical = 1;
+
+    CStr sort_attribute_cstr(sort_attribute);
+    result = ldap_create_sort_keylist(&sort_keylist, sort_attribute_cstr.data());
+    if (result != LDAP_SUCCESS) {
+        qDebug() << "Failed to create sort keylist: " << ldap_err2string(result);
+
+        cleanup();
+        return false;
+    }
+
+    result = ldap_create_sort_control(d->ld, sort_keylist, is_critical, &sort_control);
+    if (result != LDAP_SUCCESS) {
+        qDebug() << "Failed to create sort control: " << ldap_err2string(result);
+
+        cleanup();
+        return false;
+    }
+
+    // NOTE: window is requested by offset. Offset in vlv
+    // is 1-based. Content count of 0 means that we don't
+    // know it yet, in which case server treats offset as
+    // absolute. For following windows, pass back the
+    // content count and context id from previous
+    // response.
+    LDAPVLVInfo vlv_info;
+    vlv_info.ldvlv_version = 1;
+    vlv_info.ldvlv_before_count = 0;
+    vlv_info.ldvlv_after_count = count - 1;
+    vlv_info.ldvlv_offset = offset + 1;
+    vlv_info.ldvlv_count = context->m_content_count;
+    vlv_info.ldvlv_attrvalue = NULL;
+    vlv_info.ldvlv_context = context->context;
+    vlv_info.ldvlv_extradata = NULL;
+
+    result = ldap_create_vlv_control(d->ld, &vlv_info, &vlv_control);
+    if (result != LDAP_SUCCESS) {
+        qDebug() << "Failed to create vlv control: " << ldap_err2string(result);
+
+        cleanup();
+        return false;
+    }
+
+    result = create_sd_control(false, is_critical, &sd_control);
+    if (result != LDAP_SUCCESS) {
+        qDebug() << "Failed to create sd control: " << ldap_err2string(result);
+
+        cleanup();
+        return false;
+    }
+
+    LDAPControl *server_controls[4] = {sort_control, vlv_control, sd_control, NULL};
+
+    const QByteArray base_bytes = base.toUtf8();
+    const QByteArray filter_bytes = filter.toUtf8();
+    const QList<QByteArray> attributes_bytes = [&]() {
+        QList<QByteArray> out;
+
+        for (const QString &attribute : attributes) {
+            out.append(attribute.toUtf8());
+        }
+
+        return out;
+    }();
+    QVector<char *> attributes_array;
+    for (const QByteArray &attribute : attributes_bytes) {
+        attributes_array.append((char *) attribute.constData());
+    }
+    attributes_array.append(NULL);
+
+    const char *filter_cstr = (filter.isEmpty() ? NULL : filter_bytes.constData());
+    char **attributes_cstr = (attributes.isEmpty() ? NULL : attributes_array.data());
+
+    int msgid;
+    const int attrsonly = 0;
+    result = ldap_search_ext(d->ld, base_bytes.constData(), search_scope_to_ldap(scope), filter_cstr, attributes_cstr, attrsonly, server_controls, NULL, NULL, LDAP_NO_LIMIT, &msgid);
+    if (result != LDAP_SUCCESS) {
+        qDebug() << "Error in vlv ldap_search_ext: " << ldap_err2string(result);
+
+        cleanup();
+        return false;
+    }
+
+    AdObjectBuilder builder;
+
+    res = d->search_receive(msgid, &builder);
+    if (res == NULL) {
+        cleanup();
+        return false;
+    }
+
+    int errcodep;
+    result = ldap_parse_result(d->ld, res, &errcodep, NULL, NULL, NULL, &returned_controls, false);
+    if (result != LDAP_SUCCESS || errcodep != LDAP_SUCCESS) {
+        qDebug() << "Error in vlv search: " << ldap_err2string(result != LDAP_SUCCESS ? result : errcodep);
+
+        cleanup();
+        return false;
+    }
+
+    LDAPControl *vlv_response_control = ldap_control_find(LDAP_CONTROL_VLVRESPONSE, returned_controls, NULL);
+    if (vlv_response_control == NULL) {
+        qDebug() << "Vlv search didn't return response control";
+
+        cleanup();
+        return false;
+    }
+
+    ber_int_t target_pos;
+    ber_int_t list_count;
+    int vlv_errcode;
+    result = ldap_parse_vlvresponse_control(d->ld, vlv_response_control, &target_pos, &list_count, &new_context, &vlv_errcode);
+    if (result != LDAP_SUCCESS || vlv_errcode != LDAP_SUCCESS) {
+        qDebug() << "Vlv search failed: " << ldap_err2string(result != LDAP_SUCCESS ? result : vlv_errcode);
+
+        cleanup();
+        return false;
+    }
+
+    builder.finish(results);
+
+    ber_bvfree(context->context);
+    context->context = new_context;
+    context->m_content_count = list_count;
+    new_context = NULL;
+
+    cleanup();
+    return true;
+}
+
+AdObject AdInterface::search_object(const QString &dn, const QList<QString> &attributes, const bool get_sacl) {
+    const QString base = dn;
+    const SearchScope scope = SearchScope_Object;
+    const QString filter = QString();
+    const QHash<QString, AdObject> results = search(base, scope, filter, attributes, get_sacl);
+
+    if (results.contains(dn)) {
+        return results[dn];
+    } else {
+        return AdObject();
+    }
+}
+
+QHash<QString, AdObject> AdInterface::search_objects(const QList<QString> &dn_list, const QList<QString> &attributes, const bool get_sacl) {
+    const QList<AdSearchArgs> args_list = [&]() {
+        QList<AdSearchArgs> out;
+
+        for (const QString &dn : dn_list) {
+            AdSearchArgs args;
+            args.base = dn;
+            args.scope = SearchScope_Object;
+            args.attributes = attributes;
+            args.get_sacl = get_sacl;
+
+            out.append(args);
+        }
+
+        return out;
+    }();
+
+    const QList<QHash<QString, AdObject>> results_list = search_concurrent(args_list);
+
+    QHash<QString, AdObject> out;
+
+    for (int i = 0; i < dn_list.size(); i++) {
+        const QString &dn = dn_list[i];
+        const QHash<QString, AdObject> &results = results_list[i];
+
+        if (results.contains(dn)) {
+            out[dn] = results[dn];
+        }
+    }
+
+    return out;
+}
+
+// NOTE: a missing object can't be distinguished from a
+// failed search in results of search_objects(), so each
+// object is checked by it's own base search
+QHash<QString, bool> AdInterface::objects_exist(const QList<QString> &dn_list) {
+    QHash<QString, bool> out;
+
+    for (const QString &dn : dn_list) {
+        QHash<QString, AdObject> results;
+        AdCookie cookie;
+
+        const bool success = search_paged(dn, SearchScope_Object, QString(), {ATTRIBUTE_DN}, &results, &cookie);
+
+        if (success) {
+            out[dn] = results.contains(dn);
+        } else if (d->get_ldap_result() == LDAP_NO_SUCH_OBJECT) {
+            out[dn] = false;
+        }
+    }
+
+    return out;
+}
+
+bool AdInterface::attribute_replace_values(const QString &dn, const QString &attribute, const QList<QByteArray> &values, const DoStatusMsg do_msg) {
+    // NOTE: old values are only needed for messages, so
+    // if messages are off, don't read them and rely on
+    // the result of modify alone
+    if (do_msg == DoStatusMsg_No) {
+        return d->attribute_replace_values(dn, attribute, values, nullptr, do_msg);
+    }
+
+    const AdObject object = search_object(dn, {attribute});
+    const QList<QByteArray> old_values = object.get_values(attribute);
+
+    return d->attribute_replace_values(dn, attribute, values, &old_values, do_msg);
+}
+
+bool AdInterface::attribute_replace_values(const QString &dn, const QString &attribute, const QList<QByteArray> &values, const QList<QByteArray> &old_values, const DoStatusMsg do_msg) {
+    return d->attribute_replace_values(dn, attribute, values, &old_values, do_msg);
+}
+
+bool AdInterfacePrivate::attribute_replace_values(const QString &dn, const QString &attribute, const QList<QByteArray> &values, const QList<QByteArray> *old_values, const DoStatusMsg do_msg) {
+    // Do nothing if both new and old values are empty
+    if (old_values != nullptr && old_values->isEmpty() && values.isEmpty()) {
+        return true;
+    }
+
+    // NOTE: store bvalues in array instead of dynamically allocating ptrs
+    struct berval bvalues_storage[values.size()];
+    struct berval *bvalues[values.size() + 1];
+    bvalues[values.size()] = NULL;
+    for (int i = 0; i < values.size(); i++) {
+        const QByteArray value = values[i];
+        struct berval *bvalue = &(bvalues_storage[i]);
+
+        bvalue->bv_val = (char *) value.constData();
+        bvalue->bv_len = (size_t) value.size();
+
+        bvalues[i] = bvalue;
+    }
+
+    CStr attribute_cstr(attribute);
+
+    LDAPMod attr;
+    attr.mod_op = (LDAP_MOD_REPLACE | LDAP_MOD_BVALUES);
+    attr.mod_type = attribute_cstr.data();
+    attr.mod_bvalues = bvalues;
+
+    LDAPMod *attrs[] = {&attr, NULL};
+
+    const int result = ldap_modify_ext_s(ld, CStr(dn), attrs, NULL, NULL);
+
+    // NOTE: old values are not given only when messages
+    // are off, so skip making display strings
+    if (do_msg == DoStatusMsg_No || old_values == nullptr) {
+        return (result == LDAP_SUCCESS);
+    }
+
+    const QString name = dn_get_name(dn);
+    const QString values_display = attribute_display_values(attribute, values, adconfig);
+    const QString old_values_display = attribute_display_values(attribute, *old_values, adconfig);
+
+    if (result == LDAP_SUCCESS) {
+        success_message(QString(tr("Attribute %1 of object %2 was changed from \"%3\" to \"%4\".")).arg(attribute, name, old_values_display, values_display), do_msg);
+    } else {
+        const QString context = QString(tr("Failed to change attribute %1 of object %2 from \"%3\" to \"%4\".")).arg(attribute, name, old_values_display, values_display);
+
+        error_message(context, default_error(), do_msg);
+    }
+
+    return (result == LDAP_SUCCESS);
+}
+
+bool AdInterface::attribute_replace_value(const QString &dn, const QString &attribute, const QByteArray &value, const DoStatusMsg do_msg) {
+    const QList<QByteArray> values = [=]() -> QList<QByteArray> {
+        if (value.isEmpty()) {
+            return QList<QByteArray>();
+        } else {
+            return {value};
+        }
+    }();
+
+    return attribute_replace_values(dn, attribute, values, do_msg);
+}
+
+bool AdInterface::attribute_add_value(const QString &dn, const QString &attribute, const QByteArray &value, const DoStatusMsg do_msg) {
+    char *data_copy = (char *) malloc(value.size());
+    if (data_copy == NULL) {
+        return false;
+    }
+    memcpy(data_copy, value.constData(), value.size());
+
+    struct berval ber_data;
+    ber_data.bv_val = data_copy;
+    ber_data.bv_len = value.size();
+
+    struct berval *values[] = {&ber_data, NULL};
+
+    CStr attribute_cstr(attribute);
+
+    LDAPMod attr;
+    attr.mod_op = LDAP_MOD_ADD | LDAP_MOD_BVALUES;
+    attr.mod_type = attribute_cstr.data();
+    attr.mod_bvalues = values;
+
+    LDAPMod *attrs[] = {&attr, NULL};
+
+    const int result = ldap_modify_ext_s(d->ld, CStr(dn), attrs, NULL, NULL);
+    free(data_copy);
+
+    const QString name = dn_get_name(dn);
+    const QString new_display_value = attribute_display_value(attribute, value, d->adconfig);
+
+    if (result == LDAP_SUCCESS) {
+        const QString context = QString(tr("Value \"%1\" was added for attribute %2 of object %3.")).arg(new_display_value, attribute, name);
+
+        d->success_message(context, do_msg);
+
+        return true;
+    } else {
+        const QString context = QString(tr("Failed to add value \"%1\" for attribute %2 of object %3.")).arg(new_display_value, attribute, name);
+
+        d->error_message(context, d->default_error(), do_msg);
+
+        return false;
+    }
+}
+
+bool AdInterface::attribute_delete_value(const QString &dn, const QString &attribute, const QByteArray &value, const DoStatusMsg do_msg) {
+    const QString name = dn_get_name(dn);
+    const QString value_display = attribute_display_value(attribute, value, d->adconfig);
+
+    char *data_copy = (char *) malloc(value.size());
+    if (data_copy == NULL) {
+        return false;
+    }
+    memcpy(data_copy, value.constData(), value.size());
+
+    struct berval ber_data;
+    ber_data.bv_val = data_copy;
+    ber_data.bv_len = value.size();
+
+    CStr attribute_cstr(attribute);
+
+    LDAPMod attr;
+    struct berval *values[] = {&ber_data, NULL};
+    attr.mod_op = LDAP_MOD_DELETE | LDAP_MOD_BVALUES;
+    attr.mod_type = attribute_cstr.data();
+    attr.mod_bvalues = values;
+
+    LDAPMod *attrs[] = {&attr, NULL};
+
+    const int result = ldap_modify_ext_s(d->ld, CStr(dn), attrs, NULL, NULL);
+    free(data_copy);
+
+    if (result == LDAP_SUCCESS) {
+        const QString context = QString(tr("Value \"%1\" for attribute %2 of object %3 was deleted.")).arg(value_display, attribute, name);
+
+        d->success_message(context, do_msg);
+
+        return true;
+    } else {
+        const QString context = QString(tr("Failed to delete value \"%1\" for attribute %2 of object %3.")).arg(value_display, attribute, name);
+
+        d->error_message(context, d->default_error(), do_msg);
+
+        return false;
+    }
+}
+
+bool AdInterface::attribute_replace_string(const QString &dn, const QString &attribute, const QString &value, const DoStatusMsg do_msg) {
+    const QByteArray value_bytes = value.toUtf8();
+
+    return attribute_replace_value(dn, attribute, value_bytes, do_msg);
+}
+
+bool AdInterface::attribute_replace_string(const QString &dn, const QString &attribute, const QString &value, const QString &old_value, const DoStatusMsg do_msg) {
+    auto string_to_values = [](const QString &string) -> QList<QByteArray> {
+        if (string.isEmpty()) {
+            return QList<QByteArray>();
+        } else {
+            return {string.toUtf8()};
+        }
+    };
+
+    const QList<QByteArray> values = string_to_values(value);
+    const QList<QByteArray> old_values = string_to_values(old_value);
+
+    return attribute_replace_values(dn, attribute, values, old_values, do_msg);
+}
+
+bool AdInterface::attribute_replace_int(const QString &dn, const QString &attribute, const int value, const DoStatusMsg do_msg) {
+    const QString value_string = QString::number(value);
+    const bool result = attribute_replace_string(dn, attribute, value_string, do_msg);
+
+    return result;
+}
+
+bool AdInterface::modify_batch(const AdModifyBatch &batch, QList<QString> *failed_list, const DoStatusMsg do_msg) {
+    // NOTE: same as attribute_replace_values(), old
+    // values are only read when messages are on. They
+    // are read for all objects at once, using concurrent
+    // searches.
+    const QHash<QString, AdObject> old_object_map = [&]() {
+        if (do_msg == DoStatusMsg_No) {
+            return QHash<QString, AdObject>();
+        }
+
+        QList<QString> attribute_list;
+        for (const QString &dn : batch.get_dn_list()) {
+            for (const QString &attribute : batch.get_attribute_list(dn)) {
+                if (!attribute_list.contains(attribute)) {
+                    attribute_list.append(attribute);
+                }
+            }
+        }
+
+        return search_objects(batch.get_dn_list(), attribute_list);
+    }();
+
+    auto get_old_values = [&](const QString &dn, const QString &attribute) {
+        return old_object_map.value(dn).get_values(attribute);
+    };
+
+    // Skip attributes for which both new and old values
+    // are empty and objects which have nothing left to
+    // change
+    QHash<QString, QList<QString>> attribute_list_map;
+    QList<QString> dn_list;
+    for (const QString &dn : batch.get_dn_list()) {
+        QList<QString> attribute_list;
+
+        for (const QString &attribute : batch.get_attribute_list(dn)) {
+            const bool both_empty = (do_msg == DoStatusMsg_Yes && batch.get_values(dn, attribute).isEmpty() && get_old_values(dn, attribute).isEmpty());
+
+            if (!both_empty) {
+                attribute_list.append(attribute);
+            }
+        }
+
+        if (!attribute_list.isEmpty()) {
+            attribute_list_map[dn] = attribute_list;
+            dn_list.append(dn);
+        }
+    }
+
+    QList<QString> failed_out;
+
+    auto report = [&](const QString &dn, const int result) {
+        if (result != LDAP_SUCCESS) {
+            failed_out.append(dn);
+        }
+
+        if (do_msg == DoStatusMsg_No) {
+            return;
+        }
+
+        const QString name = dn_get_name(dn);
+
+        for (const QString &attribute : attribute_list_map.value(dn)) {
+            const QString values_display = attribute_display_values(attribute, batch.get_values(dn, attribute), d->adconfig);
+            const QString old_values_display = attribute_display_values(attribute, get_old_values(dn, attribute), d->adconfig);
+
+            if (result == LDAP_SUCCESS) {
+                d->success_message(QString(tr("Attribute %1 of object %2 was changed from \"%3\" to \"%4\".")).arg(attribute, name, old_values_display, values_display), do_msg);
+            } else {
+                const QString context = QString(tr("Failed to change attribute %1 of object %2 from \"%3\" to \"%4\".")).arg(attribute, name, old_values_display, values_display);
+
+                d->error_message(context, d->default_error(result), do_msg);
+            }
+        }
+    };
+
+    // Sends modify for one object, returns msgid or -1
+    // on failure
+    auto send = [&](const QString &dn) -> int {
+        const QList<QString> attribute_list = attribute_list_map.value(dn);
+
+        // NOTE: mods only need to live until request is
+        // sent, ldap_modify_ext() encodes them right away
+        int value_count = 0;
+        for (const QString &attribute : attribute_list) {
+            value_count += batch.get_values(dn, attribute).size();
+        }
+
+        QList<QByteArray> attribute_bytes_list;
+        QList<QList<QByteArray>> values_list;
+        std::vector<struct berval> bvalues_storage(value_count);
+        std::vector<struct berval *> bvalues(value_count + attribute_list.size());
+        std::vector<LDAPMod> mod_storage(attribute_list.size());
+        std::vector<LDAPMod *> mods(attribute_list.size() + 1);
+
+        int storage_i = 0;
+        int bvalues_i = 0;
+        for (int i = 0; i < attribute_list.size(); i++) {
+            const QString &attribute = attribute_list[i];
+            attribute_bytes_list.append(attribute.toUtf8());
+            values_list.append(batch.get_values(dn, attribute));
+
+            const QList<QByteArray> &values = values_list.last();
+            struct berval **attribute_bvalues = &bvalues[bvalues_i];
+
+            for (const QByteArray &value : values) {
+                struct berval *bvalue = &bvalues_storage[storage_i];
+                bvalue->bv_val = (char *) value.constData();
+                bvalue->bv_len = (size_t) value.size();
+
+                bvalues[bvalues_i] = bvalue;
+
+                storage_i++;
+                bvalues_i++;
+            }
+            bvalues[bvalues_i] = NULL;
+            bvalues_i++;
+
+            LDAPMod *mod = &mod_storage[i];
+            mod->mod_op = (LDAP_MOD_REPLACE | LDAP_MOD_BVALUES);
+            mod->mod_type = (char *) attribute_bytes_list.last().constData();
+            mod->mod_bvalues = attribute_bvalues;
+
+            mods[i] = mod;
         }
-    }();
+        mods[attribute_list.size()] = NULL;
 
-    return attribute_replace_values(dn, attribute, values, do_msg);
-}
+        const QByteArray dn_bytes = dn.toUtf8();
 
-bool AdInterface::attribute_add_value(const QString &dn, const QString &attribute, const QByteArray &value, const DoStatusMsg do_msg) {
-    char *data_copy = (char *) malloc(value.size());
-    if (data_copy == NULL) {
-        return false;
-    }
-    memcpy(data_copy, value.constData(), value.size());
+        int msgid;
+        const int result = ldap_modify_ext(d->ld, dn_bytes.constData(), mods.data(), NULL, NULL, &msgid);
 
-    struct berval ber_data;
-    ber_data.bv_val = data_copy;
-    ber_data.bv_len = value.size();
+        if (result != LDAP_SUCCESS) {
+            report(dn, result);
 
-    struct berval *values[] = {&ber_data, NULL};
+            return -1;
+        }
 
-    LDAPMod attr;
-    attr.mod_op = LDAP_MOD_ADD | LDAP_MOD_BVALUES;
-    attr.mod_type = (char *) cstr(attribute);
-    attr.mod_bvalues = values;
+        return msgid;
+    };
 
-    LDAPMod *attrs[] = {&attr, NULL};
+    QHash<int, QString> pending_map;
+    int next_i = 0;
 
-    const int result = ldap_modify_ext_s(d->ld, cstr(dn), attrs, NULL, NULL);
-    free(data_copy);
+    while (next_i < dn_list.size() || !pending_map.isEmpty()) {
+        // Fill the window
+        while (next_i < dn_list.size() && pending_map.size() < MODIFY_BATCH_MAX) {
+            const QString dn = dn_list[next_i];
+            next_i++;
 
-    const QString name = dn_get_name(dn);
-    const QString new_display_value = attribute_display_value(attribute, value, d->adconfig);
+            const int msgid = send(dn);
+            if (msgid != -1) {
+                pending_map[msgid] = dn;
+            }
+        }
 
-    if (result == LDAP_SUCCESS) {
-        const QString context = QString(tr("Value \"%1\" was added for attribute %2 of object %3.")).arg(new_display_value, attribute, name);
+        if (pending_map.isEmpty()) {
+            continue;
+        }
 
-        d->success_message(context, do_msg);
+        // Wait for any reply
+        LDAPMessage *res = NULL;
+        const int msg_type = ldap_result(d->ld, LDAP_RES_ANY, LDAP_MSG_ALL, NULL, &res);
 
-        return true;
-    } else {
-        const QString context = QString(tr("Failed to add value \"%1\" for attribute %2 of object %3.")).arg(new_display_value, attribute, name);
+        const bool result_error = (msg_type == -1 || msg_type == 0);
+        if (result_error) {
+            // NOTE: connection is in a bad state, so
+            // abandon everything that's left and fail it
+            qDebug() << "Failed to get modify result: " << ldap_err2string(d->get_ldap_result());
 
-        d->error_message(context, d->default_error(), do_msg);
+            ldap_msgfree(res);
 
-        return false;
-    }
-}
+            const int result = d->get_ldap_result();
 
-bool AdInterface::attribute_delete_value(const QString &dn, const QString &attribute, const QByteArray &value, const DoStatusMsg do_msg) {
-    const QString name = dn_get_name(dn);
-    const QString value_display = attribute_display_value(attribute, value, d->adconfig);
+            for (const int msgid : pending_map.keys()) {
+                ldap_abandon_ext(d->ld, msgid, NULL, NULL);
+                d->has_pending_ops = true;
+                report(pending_map[msgid], result);
+            }
+            pending_map.clear();
 
-    char *data_copy = (char *) malloc(value.size());
-    if (data_copy == NULL) {
-        return false;
-    }
-    memcpy(data_copy, value.constData(), value.size());
+            for (; next_i < dn_list.size(); next_i++) {
+                report(dn_list[next_i], result);
+            }
 
-    struct berval ber_data;
-    ber_data.bv_val = data_copy;
-    ber_data.bv_len = value.size();
+            break;
+        }
 
-    LDAPMod attr;
-    struct berval *values[] = {&ber_data, NULL};
-    attr.mod_op = LDAP_MOD_DELETE | LDAP_MOD_BVALUES;
-    attr.mod_type = (char *) cstr(attribute);
-    attr.mod_bvalues = values;
+        // NOTE: skip replies to operations that are not
+        // part of this batch
+        const int msgid = ldap_msgid(res);
+        if (!pending_map.contains(msgid)) {
+            ldap_msgfree(res);
 
-    LDAPMod *attrs[] = {&attr, NULL};
+            continue;
+        }
 
-    const int result = ldap_modify_ext_s(d->ld, cstr(dn), attrs, NULL, NULL);
-    free(data_copy);
+        const QString dn = pending_map.take(msgid);
 
-    if (result == LDAP_SUCCESS) {
-        const QString context = QString(tr("Value \"%1\" for attribute %2 of object %3 was deleted.")).arg(value_display, attribute, name);
+        const int result = [&]() {
+            if (msg_type != LDAP_RES_MODIFY) {
+                ldap_msgfree(res);
 
-        d->success_message(context, do_msg);
+                return LDAP_OTHER;
+            }
 
-        return true;
-    } else {
-        const QString context = QString(tr("Failed to delete value \"%1\" for attribute %2 of object %3.")).arg(value_display, attribute, name);
+            int errcode;
+            const int parse_result = ldap_parse_result(d->ld, res, &errcode, NULL, NULL, NULL, NULL, 1);
 
-        d->error_message(context, d->default_error(), do_msg);
+            return (parse_result == LDAP_SUCCESS ? errcode : parse_result);
+        }();
 
-        return false;
+        report(dn, result);
     }
-}
-
-bool AdInterface::attribute_replace_string(const QString &dn, const QString &attribute, const QString &value, const DoStatusMsg do_msg) {
-    const QByteArray value_bytes = value.toUtf8();
 
-    return attribute_replace_value(dn, attribute, value_bytes, do_msg);
-}
+    if (failed_list != nullptr) {
+        *failed_list = failed_out;
+    }
 
-bool AdInterface::attribute_replace_int(const QString &dn, const QString &attribute, const int value, const DoStatusMsg do_msg) {
-    const QString value_string = QString::number(value);
-    const bool result = attribute_replace_string(dn, attribute, value_string, do_msg);
+    const bool success = failed_out.isEmpty();
 
-    return result;
+    return success;
 }
 
 bool AdInterface::attribute_replace_datetime(const QString &dn, const QString &attribute, const QDateTime &datetime) {
@@ -802,11 +1797,11 @@ bool AdInterface::object_add(const QString &dn, const QHash<QString, QList<QStri
             char **value_array = (char **) malloc((value_list.size() + 1) * sizeof(char *));
             for (int j = 0; j < value_list.size(); j++) {
                 const QString value = value_list[j];
-                value_array[j] = (char *) strdup(cstr(value));
+                value_array[j] = strdup(CStr(value));
             }
             value_array[value_list.size()] = NULL;
 
-            attr->mod_type = (char *) strdup(cstr(attr_name));
+            attr->mod_type = strdup(CStr(attr_name));
             attr->mod_op = LDAP_MOD_ADD;
             attr->mod_values = value_array;
 
@@ -818,7 +1813,7 @@ bool AdInterface::object_add(const QString &dn, const QHash<QString, QList<QStri
         return out;
     }();
 
-    const int result = ldap_add_ext_s(d->ld, cstr(dn), attrs, NULL, NULL);
+    const int result = ldap_add_ext_s(d->ld, CStr(dn), attrs, NULL, NULL);
 
     ldap_mods_free(attrs, 1);
 
@@ -866,46 +1861,163 @@ bool AdInterface::object_add(const QString &dn, const QString &object_class) {
 }
 
 bool AdInterface::object_delete(const QString &dn, const DoStatusMsg do_msg) {
-    int result;
-    LDAPControl *tree_delete_control = NULL;
+    const QList<QString> deleted_list = object_delete_list({dn}, nullptr, 1, do_msg);
+    const bool success = deleted_list.contains(dn);
 
-    auto cleanup = [tree_delete_control]() {
-        ldap_control_free(tree_delete_control);
-    };
+    return success;
+}
 
-    const QString name = dn_get_name(dn);
+QList<QString> AdInterface::object_delete_list(const QList<QString> &dn_list, const std::function<void(const QString &, const bool)> &on_result, const int max_in_flight, const DoStatusMsg do_msg, QList<QString> *unknown_list) {
+    QList<QString> deleted_list;
+    QList<QString> unknown_out;
 
-    const QString error_context = QString(tr("Failed to delete object %1.")).arg(name);
+    auto report = [&](const QString &dn, const int result, const QString &error) {
+        const QString name = dn_get_name(dn);
+        const bool success = (result == LDAP_SUCCESS);
 
-    // Use a tree delete control to enable recursive delete
-    result = ldap_control_create(LDAP_CONTROL_X_TREE_DELETE, 1, NULL, 0, &tree_delete_control);
-    if (result != LDAP_SUCCESS) {
-        d->error_message(error_context, tr("LDAP Operation error - Failed to create tree delete control."));
-        cleanup();
+        if (success) {
+            d->success_message(QString(tr("Object %1 was deleted.")).arg(name), do_msg);
 
-        return false;
-    }
+            deleted_list.append(dn);
+        } else {
+            const QString error_context = QString(tr("Failed to delete object %1.")).arg(name);
+
+            d->error_message(error_context, error, do_msg);
+        }
+
+        if (on_result) {
+            on_result(dn, success);
+        }
+    };
 
+    // NOTE: tree delete control is prepared once and
+    // reused for all deletes. Use it to enable recursive
+    // delete, if server supports it.
+    LDAPControl *tree_delete_control = NULL;
     LDAPControl *server_controls[2] = {NULL, NULL};
 
     const bool tree_delete_is_supported = adconfig()->control_is_supported(LDAP_CONTROL_X_TREE_DELETE);
     if (tree_delete_is_supported) {
+        const int result = ldap_control_create(LDAP_CONTROL_X_TREE_DELETE, 1, NULL, 0, &tree_delete_control);
+
+        if (result != LDAP_SUCCESS) {
+            for (const QString &dn : dn_list) {
+                report(dn, result, tr("LDAP Operation error - Failed to create tree delete control."));
+            }
+
+            return deleted_list;
+        }
+
         server_controls[0] = tree_delete_control;
     }
 
-    result = ldap_delete_ext_s(d->ld, cstr(dn), server_controls, NULL);
+    QHash<int, QString> pending_map;
+    int next_i = 0;
 
-    cleanup();
+    while (next_i < dn_list.size() || !pending_map.isEmpty()) {
+        // Fill the window
+        while (next_i < dn_list.size() && pending_map.size() < qMax(1, max_in_flight)) {
+            const QString dn = dn_list[next_i];
+            next_i++;
 
-    if (result == LDAP_SUCCESS) {
-        d->success_message(QString(tr("Object %1 was deleted.")).arg(name), do_msg);
+            const QByteArray dn_bytes = dn.toUtf8();
 
-        return true;
-    } else {
-        d->error_message(error_context, d->default_error(), do_msg);
+            int msgid;
+            const int result = ldap_delete_ext(d->ld, dn_bytes.constData(), server_controls, NULL, &msgid);
 
-        return false;
+            if (result == LDAP_SUCCESS) {
+                pending_map[msgid] = dn;
+            } else {
+                report(dn, result, d->default_error(result));
+            }
+        }
+
+        if (pending_map.isEmpty()) {
+            continue;
+        }
+
+        // Wait for any reply
+        struct timeval timeout;
+        timeout.tv_sec = DELETE_LIST_REPLY_TIMEOUT_SECS;
+        timeout.tv_usec = 0;
+
+        LDAPMessage *res = NULL;
+        const int msg_type = ldap_result(d->ld, LDAP_RES_ANY, LDAP_MSG_ALL, &timeout, &res);
+
+        const bool result_error = (msg_type == -1 || msg_type == 0);
+        if (result_error) {
+            // NOTE: replies for deletes that are in flight
+            // are missing, but server may still have
+            // completed them, so their outcome is unknown.
+            // Abandon them and let caller check whether
+            // objects still exist. Deletes that weren't
+            // sent yet are failed.
+            ldap_msgfree(res);
+
+            const QString error = [&]() {
+                if (msg_type == 0) {
+                    return tr("Timed out waiting for server reply.");
+                } else {
+                    return d->default_error();
+                }
+            }();
+
+            qDebug() << "Failed to get delete result: " << error;
+
+            for (const int msgid : pending_map.keys()) {
+                ldap_abandon_ext(d->ld, msgid, NULL, NULL);
+                d->has_pending_ops = true;
+
+                const QString dn = pending_map[msgid];
+                const QString name = dn_get_name(dn);
+                const QString error_context = QString(tr("Failed to get result of deleting object %1, object may or may not be deleted.")).arg(name);
+                d->error_message(error_context, error, do_msg);
+
+                unknown_out.append(dn);
+            }
+            pending_map.clear();
+
+            for (; next_i < dn_list.size(); next_i++) {
+                report(dn_list[next_i], LDAP_OTHER, error);
+            }
+
+            break;
+        }
+
+        // NOTE: skip replies to operations that are not
+        // part of this delete
+        const int msgid = ldap_msgid(res);
+        if (!pending_map.contains(msgid)) {
+            ldap_msgfree(res);
+
+            continue;
+        }
+
+        const QString dn = pending_map.take(msgid);
+
+        const int result = [&]() {
+            if (msg_type != LDAP_RES_DELETE) {
+                ldap_msgfree(res);
+
+                return LDAP_OTHER;
+            }
+
+            int errcode;
+            const int parse_result = ldap_parse_result(d->ld, res, &errcode, NULL, NULL, NULL, NULL, 1);
+
+            return (parse_result == LDAP_SUCCESS ? errcode : parse_result);
+        }();
+
+        report(dn, result, d->default_error(result));
     }
+
+    ldap_control_free(tree_delete_control);
+
+    if (unknown_list != nullptr) {
+        *unknown_list = unknown_out;
+    }
+
+    return deleted_list;
 }
 
 bool AdInterface::object_move(const QString &dn, const QString &new_container) {
@@ -914,7 +2026,7 @@ bool AdInterface::object_move(const QString &dn, const QString &new_container) {
     const QString object_name = dn_get_name(dn);
     const QString container_name = dn_get_name(new_container);
 
-    const int result = ldap_rename_s(d->ld, cstr(dn), cstr(rdn), cstr(new_container), 1, NULL, NULL);
+    const int result = ldap_rename_s(d->ld, CStr(dn), CStr(rdn), CStr(new_container), 1, NULL, NULL);
 
     if (result == LDAP_SUCCESS) {
         d->success_message(QString(tr("Object %1 was moved to %2.")).arg(object_name, container_name));
@@ -934,7 +2046,7 @@ bool AdInterface::object_rename(const QString &dn, const QString &new_name) {
     const QString new_rdn = new_dn.split(",")[0];
     const QString old_name = dn_get_name(dn);
 
-    const int result = ldap_rename_s(d->ld, cstr(dn), cstr(new_rdn), NULL, 1, NULL, NULL);
+    const int result = ldap_rename_s(d->ld, CStr(dn), CStr(new_rdn), NULL, 1, NULL, NULL);
 
     if (result == LDAP_SUCCESS) {
         d->success_message(QString(tr("Object %1 was renamed to %2.")).arg(old_name, new_name));
@@ -1048,7 +2160,7 @@ bool AdInterface::group_set_type(const QString &dn, GroupType type) {
     const QString name = dn_get_name(dn);
     const QString type_string = group_type_string(type);
 
-    const bool result = attribute_replace_string(dn, ATTRIBUTE_GROUP_TYPE, update_group_type_string);
+    const bool result = attribute_replace_string(dn, ATTRIBUTE_GROUP_TYPE, update_group_type_string, object.get_string(ATTRIBUTE_GROUP_TYPE));
     if (result) {
         d->success_message(QString(tr("Group type for %1 was changed to \"%2\".")).arg(name, type_string));
 
@@ -1308,7 +2420,7 @@ bool AdInterface::gpo_add(const QString &display_name, QString &dn_out) {
         }
 
         struct stat filestat;
-        const int stat_result = smbc_stat(cstr(gpt_path), &filestat);
+        const int stat_result = smbc_stat(CStr(gpt_path), &filestat);
         const bool gpt_exists = (stat_result == 0);
         if (gpt_exists) {
             d->delete_gpt(gpt_path);
@@ -1321,7 +2433,7 @@ bool AdInterface::gpo_add(const QString &display_name, QString &dn_out) {
 
     // Create root dir
     // "smb://domain.alt/sysvol/domain.alt/Policies/{FF7E0880-F3AD-4540-8F1D-4472CB4A7044}"
-    const int result_mkdir_gpt = smbc_mkdir(cstr(gpt_path), 0755);
+    const int result_mkdir_gpt = smbc_mkdir(CStr(gpt_path), 0755);
     if (result_mkdir_gpt != 0) {
         error_message(tr("Failed to create GPT root dir."));
 
@@ -1331,7 +2443,7 @@ bool AdInterface::gpo_add(const QString &display_name, QString &dn_out) {
     }
 
     const QString gpt_machine_path = gpt_path + "/Machine";
-    const int result_mkdir_machine = smbc_mkdir(cstr(gpt_machine_path), 0755);
+    const int result_mkdir_machine = smbc_mkdir(CStr(gpt_machine_path), 0755);
     if (result_mkdir_machine != 0) {
         error_message(tr("Failed to create GPT machine dir."));
 
@@ -1341,7 +2453,7 @@ bool AdInterface::gpo_add(const QString &display_name, QString &dn_out) {
     }
 
     const QString gpt_user_path = gpt_path + "/User";
-    const int result_mkdir_user = smbc_mkdir(cstr(gpt_user_path), 0755);
+    const int result_mkdir_user = smbc_mkdir(CStr(gpt_user_path), 0755);
     if (result_mkdir_user != 0) {
         error_message(tr("Failed to create GPT user dir."));
 
@@ -1351,7 +2463,7 @@ bool AdInterface::gpo_add(const QString &display_name, QString &dn_out) {
     }
 
     const QString gpt_ini_path = gpt_path + "/GPT.INI";
-    const int ini_file = smbc_open(cstr(gpt_ini_path), O_WRONLY | O_CREAT, 0644);
+    const int ini_file = smbc_open(CStr(gpt_ini_path), O_WRONLY | O_CREAT, 0644);
     if (ini_file < 0) {
         error_message(tr("Failed to open GPT ini file."));
 
@@ -1396,116 +2508,334 @@ bool AdInterface::gpo_add(const QString &display_name, QString &dn_out) {
     for (const QString &attribute : attribute_value_map.keys()) {
         const QString value = attribute_value_map[attribute];
 
-        const bool replace_success = attribute_replace_string(gpc_dn, attribute, value);
+        const bool replace_success = attribute_replace_string(gpc_dn, attribute, value);
+
+        if (!replace_success) {
+            error_message(QString(tr("Failed to set GPC attribute %1.")).arg(attribute));
+
+            cleanup();
+
+            return false;
+        }
+    }
+
+    // User object
+    const QString user_dn = "CN=User," + gpc_dn;
+    const bool result_add_user = object_add(user_dn, CLASS_CONTAINER);
+    attribute_replace_string(gpc_dn, ATTRIBUTE_SHOW_IN_ADVANCED_VIEW_ONLY, "TRUE");
+    if (!result_add_user) {
+        error_message(tr("Failed to create user folder object for GPO."));
+
+        cleanup();
+
+        return false;
+    }
+
+    // Machine object
+    const QString machine_dn = "CN=Machine," + gpc_dn;
+    const bool result_add_machine = object_add(machine_dn, CLASS_CONTAINER);
+    attribute_replace_string(gpc_dn, ATTRIBUTE_SHOW_IN_ADVANCED_VIEW_ONLY, "TRUE");
+    if (!result_add_machine) {
+        error_message(tr("Failed to create machine folder object for GPO."));
+
+        cleanup();
+
+        return false;
+    }
+
+    const bool sync_perms_success = gpo_sync_perms(gpc_dn);
+
+    if (!sync_perms_success) {
+        // NOTE: don't fail if failed to sync perms, user
+        // can retry it later
+    }
+
+    dn_out = gpc_dn;
+
+    return true;
+}
+
+QList<AdGptEntry> AdInterfacePrivate::gpo_get_gpt_contents(const QString &gpt_root_path, bool *ok) {
+    const QString error_context = QString(tr("Failed to get contents of GPT \"%1\".")).arg(gpt_root_path);
+
+    QList<AdGptEntry> out;
+
+    AdGptEntry root_entry;
+    root_entry.path = gpt_root_path;
+    root_entry.is_dir = true;
+    root_entry.depth = 0;
+    out.append(root_entry);
+
+    // NOTE: walk GPT level by level. All folders of one
+    // level are listed concurrently. Listings are added in
+    // order of folders, so output is in order of
+    // increasing depth and same for every walk.
+    QList<QString> level = {gpt_root_path};
+    int depth = 0;
+
+    while (!level.isEmpty()) {
+        const QVector<AdGptDirListing> listing_list = gpt_list_dirs(level);
+        depth++;
+
+        QList<QString> next_level;
+
+        for (const AdGptDirListing &listing : listing_list) {
+            if (listing.open_failed || listing.read_failed) {
+                *ok = false;
+
+                const QString error = (listing.open_failed ? tr("Failed to open dir.") : tr("Failed to read dir."));
+                error_message(error_context, error);
+
+                return QList<AdGptEntry>();
+            }
+
+            for (AdGptEntry entry : listing.entry_list) {
+                entry.depth = depth;
+                out.append(entry);
+
+                if (entry.is_dir) {
+                    next_level.append(entry.path);
+                }
+            }
+        }
+
+        level = next_level;
+    }
+
+    return out;
+}
+
+// Returns GPT descriptor as a string of comma separated
+// entries. On failure returns empty string and sets error
+// to errno.
+QString gpt_sd_read(SMBCCTX *context, const QString &smb_path, int *error) {
+    const CStr smb_path_cstr(smb_path);
+
+    // NOTE: the length of gpt sd string doesn't have a
+    // well defined bound, so we have to use an
+    // expanding buffer
+    QByteArray buffer(4096, '\0');
+
+    while (true) {
+        const int getxattr_result = smbc_getFunctionGetxattr(context)(context, smb_path_cstr, "system.nt_sec_desc.*", buffer.data(), buffer.size());
+
+        // NOTE: for some reason getxattr() returns positive
+        // non-zero return code on success, even though f-n
+        // description says it "returns 0 on success"
+        const bool success = (getxattr_result >= 0);
+
+        if (success) {
+            break;
+        } else {
+            const bool buffer_is_too_small = (errno == ERANGE);
+
+            if (buffer_is_too_small) {
+                // Error occured, but it is due to
+                // insufficient buffer size, so try
+                // again with bigger buffer
+                buffer.resize(2 * buffer.size());
+            } else {
+                *error = errno;
+
+                return QString();
+            }
+        }
+    }
+
+    return QString(buffer.constData());
+}
+
+// SD's match if they contain the same set of entries.
+// Order doesn't matter. Note that simple equality doesn't
+// work because entry order may not match.
+//
+// NOTE: there's also a weird thing where RSAT creates
+// GPO's with duplicate ace's for Domain Admins. Not sure
+// why that happens but comparing sets ignores that quirk.
+bool gpt_sd_match(const QString &gpc_sd, const QString &gpt_sd) {
+    const QList<QString> gpc_list = gpc_sd.split(",");
+    const QList<QString> gpt_list = gpt_sd.split(",");
+
+    const QSet<QString> gpc_set = QSet<QString>(gpc_list.begin(), gpc_list.end());
+    const QSet<QString> gpt_set = QSet<QString>(gpt_list.begin(), gpt_list.end());
+
+    return (gpc_set == gpt_set);
+}
+
+AdGptDirListing gpt_list_dir(SMBCCTX *context, const QString &path) {
+    AdGptDirListing out;
+
+    SMBCFILE *dir = smbc_getFunctionOpendir(context)(context, CStr(path));
+
+    if (dir == NULL) {
+        out.open_failed = true;
+
+        return out;
+    }
+
+    // NOTE: set errno to 0, so that we know
+    // when readdir() fails because it will
+    // change errno.
+    errno = 0;
+
+    struct smbc_dirent *child_dirent;
+    while ((child_dirent = smbc_getFunctionReaddir(context)(context, dir)) != NULL) {
+        const QString child_name = QString(child_dirent->name);
+
+        const bool is_dot_path = (child_name == "." || child_name == "..");
+        if (is_dot_path) {
+            continue;
+        }
+
+        // NOTE: dirent already contains the type, so
+        // don't need to stat children
+        AdGptEntry entry;
+        entry.path = path + "/" + child_name;
+        entry.is_dir = (child_dirent->smbc_type == SMBC_DIR);
+
+        out.entry_list.append(entry);
+    }
+
+    if (errno != 0) {
+        out.read_failed = true;
+    }
+
+    smbc_getFunctionClosedir(context)(context, dir);
 
-        if (!replace_success) {
-            error_message(QString(tr("Failed to set GPC attribute %1.")).arg(attribute));
+    return out;
+}
 
-            cleanup();
+QVector<AdGptDirListing> AdInterfacePrivate::gpt_list_dirs(const QList<QString> &dir_list) {
+    QVector<AdGptDirListing> out(dir_list.size());
+    AdGptDirListing *out_data = out.data();
 
-            return false;
+    const bool run_success = smbc_run_concurrent(dir_list.size(),
+        [&](SMBCCTX *context, const int i) {
+            out_data[i] = gpt_list_dir(context, dir_list[i]);
+        });
+
+    if (!run_success) {
+        for (AdGptDirListing &listing : out) {
+            listing.open_failed = true;
         }
     }
 
-    // User object
-    const QString user_dn = "CN=User," + gpc_dn;
-    const bool result_add_user = object_add(user_dn, CLASS_CONTAINER);
-    attribute_replace_string(gpc_dn, ATTRIBUTE_SHOW_IN_ADVANCED_VIEW_ONLY, "TRUE");
-    if (!result_add_user) {
-        error_message(tr("Failed to create user folder object for GPO."));
+    return out;
+}
 
-        cleanup();
+bool AdInterfacePrivate::smbc_run_concurrent(const int count, const std::function<void(SMBCCTX *context, const int i)> &f) {
+    // NOTE: take context for current thread first, if
+    // that fails then there's no point in starting other
+    // threads
+    SMBCCTX *own_context = smbc_context_take();
+    if (own_context == NULL) {
+        qDebug() << "Failed to get SMB context for current thread";
 
         return false;
     }
 
-    // Machine object
-    const QString machine_dn = "CN=Machine," + gpc_dn;
-    const bool result_add_machine = object_add(machine_dn, CLASS_CONTAINER);
-    attribute_replace_string(gpc_dn, ATTRIBUTE_SHOW_IN_ADVANCED_VIEW_ONLY, "TRUE");
-    if (!result_add_machine) {
-        error_message(tr("Failed to create machine folder object for GPO."));
+    QAtomicInt next_index(0);
 
-        cleanup();
+    auto run = [&](SMBCCTX *context) {
+        while (true) {
+            const int i = next_index.fetchAndAddRelaxed(1);
+            if (i >= count) {
+                break;
+            }
 
-        return false;
-    }
+            f(context, i);
+        }
+    };
 
-    const bool sync_perms_success = gpo_sync_perms(gpc_dn);
+    // NOTE: extra threads use contexts from worker pool.
+    // If there are not enough contexts, current thread
+    // does the rest of the work.
+    const int thread_count = qMin(count, GPT_WALK_THREADS_MAX);
 
-    if (!sync_perms_success) {
-        // NOTE: don't fail if failed to sync perms, user
-        // can retry it later
-    }
+    QList<SMBCCTX *> context_list;
+    std::vector<std::thread> thread_list;
 
-    dn_out = gpc_dn;
+    for (int i = 1; i < thread_count; i++) {
+        SMBCCTX *context = smbc_worker_take();
+        if (context == NULL) {
+            break;
+        }
 
-    return true;
-}
+        context_list.append(context);
+        thread_list.emplace_back(run, context);
+    }
 
-QList<QString> AdInterfacePrivate::gpo_get_gpt_contents(const QString &gpt_root_path, bool *ok) {
-    // Collect all contents of the path into a list
-    QList<QString> explore_stack;
-    QList<QString> seen_stack;
+    run(own_context);
 
-    explore_stack.append(gpt_root_path);
-    seen_stack.append(gpt_root_path);
+    for (std::thread &thread : thread_list) {
+        thread.join();
+    }
 
-    const QString error_context = QString(tr("Failed to get contents of GPT \"%1\".")).arg(gpt_root_path);
+    for (SMBCCTX *context : context_list) {
+        smbc_worker_put(context);
+    }
 
-    while (!explore_stack.isEmpty()) {
-        const QString path = explore_stack.takeLast();
+    smbc_context_put(own_context);
 
-        const int dirp = smbc_opendir(cstr(path));
+    return true;
+}
 
-        if (dirp < 0) {
-            *ok = false;
+// NOTE: main context is used by main thread without
+// locking, so other threads must never use it
+SMBCCTX *AdInterfacePrivate::smbc_context_take() {
+    QCoreApplication *app = QCoreApplication::instance();
+    const bool is_main_thread = (app == nullptr || QThread::currentThread() == app->thread());
 
-            error_message(error_context, tr("Failed to open dir."));
+    if (is_main_thread) {
+        return smbc;
+    } else {
+        return smbc_worker_take();
+    }
+}
 
-            return QList<QString>();
-        }
+void AdInterfacePrivate::smbc_context_put(SMBCCTX *context) {
+    if (context != smbc) {
+        smbc_worker_put(context);
+    }
+}
 
-        // NOTE: set errno to 0, so that we know
-        // when readdir() fails because it will
-        // change errno.
-        errno = 0;
+SMBCCTX *AdInterfacePrivate::smbc_worker_take() {
+    {
+        QMutexLocker locker(&smbc_worker_mutex);
 
-        smbc_dirent *child_dirent;
-        while ((child_dirent = smbc_readdir(dirp)) != NULL) {
-            const QString child_name = QString(child_dirent->name);
+        if (!smbc_worker_pool.isEmpty()) {
+            return smbc_worker_pool.takeLast();
+        }
+    }
 
-            const bool is_dot_path = (child_name == "." || child_name == "..");
-            if (is_dot_path) {
-                continue;
-            } else {
-                const QString child_path = path + "/" + child_name;
+    SMBCCTX *context = smbc_new_context();
+    if (context == NULL) {
+        return NULL;
+    }
 
-                seen_stack.append(child_path);
+    smbc_setFunctionAuthData(context, get_auth_data_fn);
+    smbc_setOptionUseKerberos(context, true);
+    smbc_setOptionFallbackAfterKerberos(context, true);
 
-                const bool child_is_dir = smb_path_is_dir(child_path, ok);
-                if (!*ok) {
-                    return QList<QString>();
-                }
+    if (smbc_init_context(context) == NULL) {
+        qDebug() << "Failed to initialize SMB worker context";
 
-                if (child_is_dir) {
-                    explore_stack.append(child_path);
-                }
-            }
-        }
+        smbc_free_context(context, 1);
 
-        if (errno != 0) {
-            *ok = false;
+        return NULL;
+    }
 
-            error_message(error_context, tr("Failed to read dir."));
+    return context;
+}
 
-            return QList<QString>();
-        }
+void AdInterfacePrivate::smbc_worker_put(SMBCCTX *context) {
+    QMutexLocker locker(&smbc_worker_mutex);
 
-        smbc_closedir(dirp);
+    if (smbc_worker_pool.size() < GPT_WALK_THREADS_MAX) {
+        smbc_worker_pool.append(context);
+    } else {
+        smbc_free_context(context, 1);
     }
-
-    return seen_stack;
 }
 
 bool AdInterface::gpo_delete(const QString &dn, bool *deleted_object) {
@@ -1542,7 +2872,7 @@ bool AdInterface::gpo_delete(const QString &dn, bool *deleted_object) {
         Gplink gplink = Gplink(gplink_old_string);
         gplink.remove(dn);
 
-        attribute_replace_string(linked_object.get_dn(), ATTRIBUTE_GPLINK, gplink.to_string());
+        attribute_replace_string(linked_object.get_dn(), ATTRIBUTE_GPLINK, gplink.to_string(), gplink_old_string);
     }
 
     const bool total_success = (delete_gpc_success && delete_gpt_success);
@@ -1595,116 +2925,99 @@ bool AdInterface::gpo_check_perms(const QString &gpo, bool *ok) {
 
     const QString error_context = QString(tr("Failed to check permissions for GPO \"%1\".")).arg(name);
 
-    const QString gpc_sd = [&]() {
-        const QString out = get_gpt_sd_string(gpc_object, AceMaskFormat_Hexadecimal);
+    const QString gpc_sd = get_gpt_sd_string(gpc_object, AceMaskFormat_Hexadecimal);
+    if (gpc_sd.isEmpty()) {
+        d->error_message(error_context, tr("Failed to get GPT security descriptor."));
 
-        if (out.isEmpty()) {
-            d->error_message(error_context, tr("Failed to get GPT security descriptor."));
+        *ok = false;
 
-            return QString();
-        }
+        return false;
+    }
 
-        return out;
-    }();
+    const QString filesys_path = gpc_object.get_string(ATTRIBUTE_GPC_FILE_SYS_PATH);
+    const QString smb_path = filesys_path_to_smb_path(filesys_path);
 
-    const QString gpt_sd = [&]() {
-        const QString filesys_path = gpc_object.get_string(ATTRIBUTE_GPC_FILE_SYS_PATH);
-        const QString smb_path = filesys_path_to_smb_path(filesys_path);
-        const char *smb_path_cstr = cstr(smb_path);
+    SMBCCTX *context = AdInterfacePrivate::smbc_context_take();
+    if (context == NULL) {
+        d->error_message(error_context, tr("Failed to create SMB context."));
 
-        // NOTE: the length of gpt sd string doesn't have a
-        // well defined bound, so we have to use an
-        // expanding buffer
-        size_t buffer_size = 1024 * sizeof(char);
-        char *buffer = (char *) malloc(buffer_size);
+        *ok = false;
 
-        while (true) {
-            const int getxattr_result = smbc_getxattr(smb_path_cstr, "system.nt_sec_desc.*", buffer, buffer_size);
+        return false;
+    }
 
-            // NOTE: for some reason getxattr() returns positive
-            // non-zero return code on success, even though f-n
-            // description says it "returns 0 on success"
-            const bool success = (getxattr_result >= 0);
+    int gpt_sd_error = 0;
+    const QString gpt_sd = gpt_sd_read(context, smb_path, &gpt_sd_error);
+    AdInterfacePrivate::smbc_context_put(context);
 
-            if (success) {
-                break;
-            } else {
-                const bool buffer_is_too_small = (errno == ERANGE);
-
-                if (buffer_is_too_small) {
-                    // Error occured, but it is due to
-                    // insufficient buffer size, so try
-                    // again with bigger buffer
-                    buffer_size = 2 * buffer_size;
-                    buffer = (char *) realloc(buffer, buffer_size);
-                } else {
-                    const QString text = QString(tr("Failed to get GPT security descriptor, %1.")).arg(strerror(errno));
-                    d->error_message(error_context, text);
+    if (gpt_sd.isEmpty()) {
+        const QString text = QString(tr("Failed to get GPT security descriptor, %1.")).arg(strerror(gpt_sd_error));
+        d->error_message(error_context, text);
 
-                    free(buffer);
+        *ok = false;
 
-                    return QString();
-                }
-            }
-        }
+        return false;
+    }
 
-        const QString out = QString(buffer);
+    const bool sd_match = gpt_sd_match(gpc_sd, gpt_sd);
 
-        free(buffer);
+    return sd_match;
+}
 
-        return out;
-    }();
+QHash<QString, bool> AdInterface::gpo_check_perms_list(const QList<AdObject> &gpc_list) {
+    QHash<QString, bool> out;
 
-    qDebug() << "--------";
-    qDebug() << "gpc_sd:";
-    for (auto e : QString(gpc_sd).split(",")) {
-        qDebug() << e;
+    // NOTE: skip perms check for non-admins, because don't
+    // have enough rights to get full sd
+    if (!logged_in_as_admin()) {
+        return out;
     }
 
-    qDebug() << "--------";
-    qDebug() << "gpt_sd:";
-    for (auto e : QString(gpt_sd).split(",")) {
-        qDebug() << e;
+    QList<QString> gpc_sd_list;
+    QList<QString> path_list;
+    for (const AdObject &gpc_object : gpc_list) {
+        gpc_sd_list.append(get_gpt_sd_string(gpc_object, AceMaskFormat_Hexadecimal));
+
+        const QString filesys_path = gpc_object.get_string(ATTRIBUTE_GPC_FILE_SYS_PATH);
+        path_list.append(filesys_path_to_smb_path(filesys_path));
     }
 
-    if (gpc_sd.isEmpty() || gpt_sd.isEmpty()) {
-        *ok = false;
+    // Read GPT descriptors concurrently
+    QVector<QString> gpt_sd_list(gpc_list.size());
+    QString *gpt_sd_data = gpt_sd_list.data();
 
-        return false;
+    const bool run_success = AdInterfacePrivate::smbc_run_concurrent(gpc_list.size(),
+        [&](SMBCCTX *context, const int i) {
+            int error = 0;
+            gpt_sd_data[i] = gpt_sd_read(context, path_list.at(i), &error);
+        });
+
+    if (!run_success) {
+        return out;
     }
 
-    // SD's match if they both contain all lines of the
-    // other one. Order doesn't matter. Note that
-    // simple equality doesn't work because entry order
-    // may not match.
-    //
-    // NOTE: there's also a weird thing where RSAT
-    // creates GPO's with duplicate ace's for Domain
-    // Admins. Not sure why that happens but this
-    // matching method ignores that quirk.
-    const bool sd_match = [&]() {
-        const QList<QString> gpt_list = QString(gpt_sd).split(",");
-        const QList<QString> gpc_list = QString(gpc_sd).split(",");
-
-        for (const QString &line : gpt_list) {
-            if (!gpc_list.contains(line)) {
-                return false;
-            }
-        }
+    for (int i = 0; i < gpc_list.size(); i++) {
+        const QString dn = gpc_list[i].get_dn();
+        const QString &gpc_sd = gpc_sd_list[i];
+        const QString &gpt_sd = gpt_sd_list[i];
 
-        for (const QString &line : gpc_list) {
-            if (!gpt_list.contains(line)) {
-                return false;
-            }
+        if (gpc_sd.isEmpty() || gpt_sd.isEmpty()) {
+            qDebug() << "Failed to check permissions for GPO" << dn;
+
+            continue;
         }
 
-        return true;
-    }();
+        out[dn] = gpt_sd_match(gpc_sd, gpt_sd);
+    }
 
-    return sd_match;
+    return out;
 }
 
 bool AdInterface::gpo_sync_perms(const QString &dn) {
+    return gpo_sync_perms(dn, nullptr);
+}
+
+bool AdInterface::gpo_sync_perms(const QString &dn, const std::function<void(const int done, const int total)> &on_progress, QList<QString> *failed_list, const QList<QString> &resume_list) {
     // First get GPC descriptor
     const QList<QString> attributes = QList<QString>();
     const bool get_sacl = true;
@@ -1728,21 +3041,126 @@ bool AdInterface::gpo_sync_perms(const QString &dn) {
     const QString filesys_path = gpc_object.get_string(ATTRIBUTE_GPC_FILE_SYS_PATH);
     const QString smb_path = filesys_path_to_smb_path(filesys_path);
     bool ok = true;
-    const QList<QString> path_list = d->gpo_get_gpt_contents(smb_path, &ok);
-    if (!ok || path_list.isEmpty()) {
+    const QList<AdGptEntry> entry_list = d->gpo_get_gpt_contents(smb_path, &ok);
+    if (!ok || entry_list.isEmpty()) {
         d->error_message(error_context, QString(tr("Failed to read GPT contents of \"%1\".")).arg(smb_path));
         return false;
     }
 
-    // Set descriptor on all GPT contents
-    for (const QString &path : path_list) {
-        const int set_sd_result = smbc_setxattr(cstr(path), "system.nt_sec_desc.*", cstr(gpt_sd_string), strlen(cstr(gpt_sd_string)), 0);
-        if (set_sd_result != 0) {
-            const QString error = QString(tr("Failed to set permissions, %1.")).arg(strerror(errno));
-            d->error_message(error_context, error);
+    const auto get_parent = [](const QString &path) {
+        return path.left(path.lastIndexOf('/'));
+    };
+
+    // When resuming, only sync the subtrees of resume
+    // paths. Entries are ordered by depth, so parents are
+    // always checked before their contents.
+    const QList<AdGptEntry> target_list = [&]() {
+        if (resume_list.isEmpty()) {
+            return entry_list;
+        }
+
+        const QSet<QString> resume_set = QSet<QString>(resume_list.begin(), resume_list.end());
+        QSet<QString> included_dir_set;
+        QList<AdGptEntry> out;
 
-            return false;
+        for (const AdGptEntry &entry : entry_list) {
+            const bool included = (resume_set.contains(entry.path) || included_dir_set.contains(get_parent(entry.path)));
+
+            if (included) {
+                out.append(entry);
+
+                if (entry.is_dir) {
+                    included_dir_set.insert(entry.path);
+                }
+            }
         }
+
+        return out;
+    }();
+
+    // Set descriptor on all GPT contents. Each level is
+    // done concurrently, after previous level is
+    // complete. If a folder fails, it's contents are
+    // skipped because they would fail as well.
+    const CStr gpt_sd_cstr(gpt_sd_string);
+    const int total = target_list.size();
+    int done = 0;
+    QList<QString> failed_path_list;
+    QSet<QString> skipped_dir_set;
+    int skipped_count = 0;
+
+    int level_start = 0;
+    while (level_start < target_list.size()) {
+        const int depth = target_list[level_start].depth;
+
+        QList<AdGptEntry> level;
+        int level_end = level_start;
+        for (; level_end < target_list.size() && target_list[level_end].depth == depth; level_end++) {
+            const AdGptEntry &entry = target_list[level_end];
+
+            const bool parent_failed = skipped_dir_set.contains(get_parent(entry.path));
+            if (parent_failed) {
+                skipped_count++;
+
+                if (entry.is_dir) {
+                    skipped_dir_set.insert(entry.path);
+                }
+            } else {
+                level.append(entry);
+            }
+        }
+
+        // NOTE: errno is per thread, so save it for each
+        // path
+        QVector<int> error_list(level.size());
+        int *error_data = error_list.data();
+
+        const bool run_success = AdInterfacePrivate::smbc_run_concurrent(level.size(),
+            [&](SMBCCTX *context, const int i) {
+                const int set_sd_result = smbc_getFunctionSetxattr(context)(context, CStr(level.at(i).path), "system.nt_sec_desc.*", gpt_sd_cstr, gpt_sd_cstr.size(), 0);
+
+                error_data[i] = (set_sd_result == 0 ? 0 : errno);
+            });
+
+        if (!run_success) {
+            error_list.fill(EIO);
+        }
+
+        for (int i = 0; i < level.size(); i++) {
+            const int error = error_list[i];
+
+            if (error != 0) {
+                const AdGptEntry &entry = level[i];
+
+                const QString error_text = QString(tr("Failed to set permissions for \"%1\", %2.")).arg(entry.path, strerror(error));
+                d->error_message(error_context, error_text);
+
+                failed_path_list.append(entry.path);
+
+                if (entry.is_dir) {
+                    skipped_dir_set.insert(entry.path);
+                }
+            }
+        }
+
+        done += (level_end - level_start);
+
+        if (on_progress != nullptr) {
+            on_progress(done, total);
+        }
+
+        level_start = level_end;
+    }
+
+    if (failed_list != nullptr) {
+        *failed_list = failed_path_list;
+    }
+
+    if (!failed_path_list.isEmpty()) {
+        const QString error_text = QString(tr("Failed to set permissions for %1 paths, skipped %2 paths inside failed folders.")).arg(QString::number(failed_path_list.size()), QString::number(skipped_count));
+        d->error_message(error_context, error_text);
+
+        return false;
     }
 
     d->success_message(QString(tr("Synced permissions of GPO \"%1\".")).arg(name));
@@ -1759,7 +3177,7 @@ bool AdInterface::gpo_get_sysvol_version(const AdObject &gpc_object, int *versio
 
         const QString ini_path = smb_path + "/GPT.INI";
 
-        const int ini_fd = smbc_open(cstr(ini_path), O_RDONLY, 0);
+        const int ini_fd = smbc_open(CStr(ini_path), O_RDONLY, 0);
 
         if (ini_fd < 0) {
             const QString error_text = QString(tr("Failed to open GPT.INI, %1.")).arg(strerror(errno));
@@ -1791,7 +3209,7 @@ bool AdInterface::gpo_get_sysvol_version(const AdObject &gpc_object, int *versio
     const int version = [&]() {
         int out;
 
-        const int scan_result = sscanf(cstr(ini_contents), "[General]\r\nVersion=%i\r\n", &out);
+        const int scan_result = sscanf(CStr(ini_contents), "[General]\r\nVersion=%i\r\n", &out);
         const bool scan_success = (scan_result > 0);
 
         if (!scan_success) {
@@ -1853,6 +3271,11 @@ void AdInterfacePrivate::error_message_plain(const QString &text, const DoStatus
 
 QString AdInterfacePrivate::default_error() const {
     const int ldap_result = get_ldap_result();
+
+    return default_error(ldap_result);
+}
+
+QString AdInterfacePrivate::default_error(const int ldap_result) const {
     switch (ldap_result) {
         case LDAP_NO_SUCH_OBJECT: return tr("No such object");
         case LDAP_CONSTRAINT_VIOLATION: return tr("Constraint violation");
@@ -1876,23 +3299,20 @@ int AdInterfacePrivate::get_ldap_result() const {
 bool AdInterfacePrivate::delete_gpt(const QString &parent_path) {
     bool ok = true;
 
-    QList<QString> path_list = gpo_get_gpt_contents(parent_path, &ok);
+    QList<AdGptEntry> entry_list = gpo_get_gpt_contents(parent_path, &ok);
     if (!ok) {
         return false;
     }
 
     // NOTE: have to reverse so deepest paths are first to
     // delete correctly
-    std::reverse(path_list.begin(), path_list.end());
+    std::reverse(entry_list.begin(), entry_list.end());
 
-    for (const QString &path : path_list) {
-        const bool is_dir = smb_path_is_dir(path, &ok);
-        if (!ok) {
-            return false;
-        }
+    for (const AdGptEntry &entry : entry_list) {
+        const QString &path = entry.path;
 
-        if (is_dir) {
-            const int result_rmdir = smbc_rmdir(cstr(path));
+        if (entry.is_dir) {
+            const int result_rmdir = smbc_rmdir(CStr(path));
 
             if (result_rmdir != 0) {
                 error_message(QString(tr("Failed to delete GPT folder %1.")).arg(path), strerror(errno));
@@ -1900,7 +3320,7 @@ bool AdInterfacePrivate::delete_gpt(const QString &parent_path) {
                 return false;
             }
         } else {
-            const int result_unlink = smbc_unlink(cstr(path));
+            const int result_unlink = smbc_unlink(CStr(path));
 
             if (result_unlink != 0) {
                 error_message(QString(tr("Failed to delete GPT file %1.")).arg(path), strerror(errno));
@@ -1913,24 +3333,6 @@ bool AdInterfacePrivate::delete_gpt(const QString &parent_path) {
     return true;
 }
 
-bool AdInterfacePrivate::smb_path_is_dir(const QString &path, bool *ok) {
-    struct stat filestat;
-    const int stat_result = smbc_stat(cstr(path), &filestat);
-    if (stat_result != 0) {
-        error_message(QString(tr("Failed to get filestat for \"%1\".")).arg(path), strerror(errno));
-
-        *ok = false;
-
-        return false;
-    } else {
-        *ok = true;
-
-        const bool is_dir = S_ISDIR(filestat.st_mode);
-
-        return is_dir;
-    }
-}
-
 // NOTE: this f-n is analogous to
 // ldap_create_page_control() and others. See pagectl.c
 // in ldap sources for examples. Extracted to contain
@@ -1970,6 +3372,16 @@ int create_sd_control(bool get_sacl, int iscritical, LDAPControl **ctrlp) {
     return result;
 }
 
+int search_scope_to_ldap(const SearchScope scope) {
+    switch (scope) {
+        case SearchScope_Object: return LDAP_SCOPE_BASE;
+        case SearchScope_Children: return LDAP_SCOPE_ONELEVEL;
+        case SearchScope_All: return LDAP_SCOPE_SUBTREE;
+        case SearchScope_Descendants: return LDAP_SCOPE_CHILDREN;
+    }
+    return 0;
+}
+
 bool AdInterface::logged_in_as_admin() {
     const QString user_dn = [&]() {
         const QString sam_account_name = [&]() {
@@ -2017,23 +3429,29 @@ QString AdInterface::get_dc() const {
     return d->dc;
 }
 
+void AdInterface::set_cancel_flag(const QAtomicInt *flag) {
+    d->cancel_flag = flag;
+}
+
+bool AdInterface::is_cancelled() const {
+    return d->is_cancelled();
+}
+
 QList<QString> get_domain_hosts(const QString &domain, const QString &site) {
     QList<QString> hosts;
 
     // Query site hosts
     if (!site.isEmpty()) {
-        char dname[1000];
-        snprintf(dname, sizeof(dname), "_ldap._tcp.%s._sites.%s", cstr(site), cstr(domain));
+        const QString dname = QString("_ldap._tcp.%1._sites.%2").arg(site, domain);
 
-        const QList<QString> site_hosts = query_server_for_hosts(dname);
+        const QList<QString> site_hosts = query_server_for_hosts_cached(dname);
         hosts.append(site_hosts);
     }
 
     // Query default hosts
-    char dname_default[1000];
-    snprintf(dname_default, sizeof(dname_default), "_ldap._tcp.%s", cstr(domain));
+    const QString dname_default = QString("_ldap._tcp.%1").arg(domain);
 
-    const QList<QString> default_hosts = query_server_for_hosts(dname_default);
+    const QList<QString> default_hosts = query_server_for_hosts_cached(dname_default);
     hosts.append(default_hosts);
 
     hosts.removeDuplicates();
@@ -2041,6 +3459,112 @@ QList<QString> get_domain_hosts(const QString &domain, const QString &site) {
     return hosts;
 }
 
+void get_domain_hosts_prefetch(const QString &domain, const QString &site) {
+    if (domain_hosts_prefetch.thread.joinable()) {
+        domain_hosts_prefetch.thread.join();
+    }
+
+    domain_hosts_prefetch.thread = std::thread([domain, site]() {
+        get_domain_hosts(domain, site);
+    });
+}
+
+DomainHostsPrefetch::~DomainHostsPrefetch() {
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+void get_domain_hosts_clear_cache() {
+    QMutexLocker locker(&domain_hosts_mutex);
+
+    domain_hosts_cache.clear();
+}
+
+int get_domain_hosts_query_count() {
+    return domain_hosts_query_count.loadAcquire();
+}
+
+// NOTE: lookups are done while holding the lookup mutex
+// of the name, so that if a lookup for same name is
+// already in progress (prefetch for example), we wait for
+// it's result instead of doing a duplicate lookup.
+// Lookups of different names don't wait for each other.
+QList<QString> query_server_for_hosts_cached(const QString &dname) {
+    const QSharedPointer<QMutex> lookup_mutex = [&]() {
+        QMutexLocker locker(&domain_hosts_mutex);
+
+        QSharedPointer<QMutex> &out = domain_hosts_lookup_mutex_map[dname];
+        if (out.isNull()) {
+            out = QSharedPointer<QMutex>::create();
+        }
+
+        return out;
+    }();
+
+    QMutexLocker lookup_locker(lookup_mutex.data());
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    {
+        QMutexLocker locker(&domain_hosts_mutex);
+
+        if (domain_hosts_cache.contains(dname)) {
+            const DomainHostsCacheEntry entry = domain_hosts_cache[dname];
+            const bool expired = (now >= entry.expire_time);
+
+            if (!expired) {
+                return entry.host_list;
+            }
+        }
+    }
+
+    domain_hosts_query_count.fetchAndAddOrdered(1);
+
+    QList<DomainHost> record_list = query_server_for_hosts(CStr(dname));
+
+    // Order hosts by priority, lower priority values go
+    // first. Among hosts with same priority, bigger
+    // weight goes first.
+    std::stable_sort(record_list.begin(), record_list.end(),
+        [](const DomainHost &a, const DomainHost &b) {
+            if (a.priority != b.priority) {
+                return (a.priority < b.priority);
+            } else {
+                return (a.weight > b.weight);
+            }
+        });
+
+    QList<QString> host_list;
+    for (const DomainHost &record : record_list) {
+        host_list.append(record.host);
+    }
+
+    // NOTE: don't cache failed lookups, so that next
+    // connection attempt retries the lookup
+    if (!host_list.isEmpty()) {
+        // Cache expires when first record expires
+        const int min_ttl = [&]() {
+            int out = record_list[0].ttl;
+
+            for (const DomainHost &record : record_list) {
+                out = std::min(out, record.ttl);
+            }
+
+            return out;
+        }();
+
+        DomainHostsCacheEntry entry;
+        entry.host_list = host_list;
+        entry.expire_time = now + (qint64) min_ttl * 1000;
+
+        QMutexLocker locker(&domain_hosts_mutex);
+        domain_hosts_cache[dname] = entry;
+    }
+
+    return host_list;
+}
+
 /**
  * Perform a query for dname and output hosts
  * dname is a combination of protocols (d->ldap, tcp), domain and site
@@ -2051,21 +3575,21 @@ QList<QString> get_domain_hosts(const QString &domain, const QString &site) {
  * Another example of similar procedure:
  * https://www.gnu.org/software/shishi/coverage/shishi/lib/resolv.c.gcov.html
  */
-QList<QString> query_server_for_hosts(const char *dname) {
+QList<DomainHost> query_server_for_hosts(const char *dname) {
     union dns_msg {
         HEADER header;
         unsigned char buf[NS_MAXMSG];
     } msg;
 
     auto error = []() {
-        return QList<QString>();
+        return QList<DomainHost>();
     };
 
-    const long unsigned msg_len = res_search(dname, ns_c_in, ns_t_srv, msg.buf, sizeof(msg.buf));
+    const int msg_len = res_search(dname, ns_c_in, ns_t_srv, msg.buf, sizeof(msg.buf));
 
-    const bool message_error = (msg_len < sizeof(HEADER));
+    const bool message_error = (msg_len < 0 || (size_t) msg_len < sizeof(HEADER));
     if (message_error) {
-        error();
+        return error();
     }
 
     const int packet_count = ntohs(msg.header.qdcount);
@@ -2080,13 +3604,13 @@ QList<QString> query_server_for_hosts(const char *dname) {
 
         const bool packet_error = (packet_len < 0);
         if (packet_error) {
-            error();
+            return error();
         }
 
         curr = curr + packet_len + QFIXEDSZ;
     }
 
-    QList<QString> hosts;
+    QList<DomainHost> hosts;
 
     // Process answers by collecting hosts into list
     for (int i = 0; i < answer_count; i++) {
@@ -2096,14 +3620,14 @@ QList<QString> query_server_for_hosts(const char *dname) {
 
         const bool server_error = (server_len < 0);
         if (server_error) {
-            error();
+            return error();
         }
 
         curr = curr + server_len;
 
         int record_type;
         int UNUSED(record_class);
-        int UNUSED(ttl);
+        int ttl;
         int record_len;
         GETSHORT(record_type, curr);
         GETSHORT(record_class, curr);
@@ -2112,7 +3636,7 @@ QList<QString> query_server_for_hosts(const char *dname) {
 
         unsigned char *record_end = curr + record_len;
         if (record_end > eom) {
-            error();
+            return error();
         }
 
         // Skip non-server records
@@ -2122,8 +3646,8 @@ QList<QString> query_server_for_hosts(const char *dname) {
             continue;
         }
 
-        int UNUSED(priority);
-        int UNUSED(weight);
+        int priority;
+        int weight;
         int UNUSED(port);
         GETSHORT(priority, curr);
         GETSHORT(weight, curr);
@@ -2134,10 +3658,16 @@ QList<QString> query_server_for_hosts(const char *dname) {
         const int host_len = dn_expand(msg.buf, eom, curr, host, sizeof(host));
         const bool host_error = (host_len < 0);
         if (host_error) {
-            error();
+            return error();
         }
 
-        hosts.append(QString(host));
+        DomainHost record;
+        record.host = QString(host);
+        record.priority = priority;
+        record.weight = weight;
+        record.ttl = ttl;
+
+        hosts.append(record);
 
         curr = record_end;
     }
@@ -2281,6 +3811,60 @@ AdCookie::~AdCookie() {
     ber_bvfree(cookie);
 }
 
+AdVlvContext::AdVlvContext() {
+    context = NULL;
+    m_content_count = 0;
+}
+
+AdVlvContext::~AdVlvContext() {
+    ber_bvfree(context);
+}
+
+int AdVlvContext::content_count() const {
+    return m_content_count;
+}
+
+void AdModifyBatch::replace_values(const QString &dn, const QString &attribute, const QList<QByteArray> &values) {
+    if (!attribute_list_map.contains(dn)) {
+        dn_list.append(dn);
+    }
+
+    QList<QString> &attribute_list = attribute_list_map[dn];
+    if (!attribute_list.contains(attribute)) {
+        attribute_list.append(attribute);
+    }
+
+    values_map[dn][attribute] = values;
+}
+
+void AdModifyBatch::replace_string(const QString &dn, const QString &attribute, const QString &value) {
+    const QList<QByteArray> values = [=]() -> QList<QByteArray> {
+        if (value.isEmpty()) {
+            return QList<QByteArray>();
+        } else {
+            return {value.toUtf8()};
+        }
+    }();
+
+    replace_values(dn, attribute, values);
+}
+
+bool AdModifyBatch::is_empty() const {
+    return dn_list.isEmpty();
+}
+
+QList<QString> AdModifyBatch::get_dn_list() const {
+    return dn_list;
+}
+
+QList<QString> AdModifyBatch::get_attribute_list(const QString &dn) const {
+    return attribute_list_map.value(dn);
+}
+
+QList<QByteArray> AdModifyBatch::get_values(const QString &dn, const QString &attribute) const {
+    return values_map.value(dn).value(attribute);
+}
+
 AdMessage::AdMessage(const QString &text, const AdMessageType &type) {
     m_text = text;
     m_type = type;
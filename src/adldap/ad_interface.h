@@ -28,7 +28,10 @@
 
 #include <QCoreApplication>
 #include <QHash>
+#include <QList>
 #include <QSet>
+#include <QString>
+#include <functional>
 
 #include "ad_defines.h"
 
@@ -38,6 +41,7 @@ class QByteArray;
 class QDateTime;
 class AdObject;
 class AdConfig;
+class QAtomicInt;
 template <typename T>
 class QList;
 typedef void TALLOC_CTX;
@@ -69,6 +73,63 @@ private:
     friend class AdInterfacePrivate;
 };
 
+// State of a vlv search that is carried between windows.
+// Contains the context id returned by server, which lets
+// server continue from the state of previous window
+// instead of redoing the sort, and the total number of
+// objects. Context is only valid for the connection that
+// it was received on, so reuse it only with same
+// AdInterface.
+class AdVlvContext {
+public:
+    AdVlvContext();
+    ~AdVlvContext();
+
+    int content_count() const;
+
+private:
+    struct berval *context;
+    int m_content_count;
+
+    friend class AdInterface;
+};
+
+// Default max number of deletes that
+// object_delete_list() keeps in flight
+#define OBJECT_DELETE_LIST_MAX 16
+
+// Arguments for one search done by
+// AdInterface::search_concurrent()
+class AdSearchArgs {
+public:
+    QString base;
+    SearchScope scope;
+    QString filter;
+    QList<QString> attributes;
+    bool get_sacl = false;
+};
+
+// Attribute changes for multiple objects, applied
+// together by AdInterface::modify_batch(). Changes are
+// kept in order of objects being added. Replacing same
+// attribute of same object again overwrites previous
+// values.
+class AdModifyBatch {
+public:
+    void replace_values(const QString &dn, const QString &attribute, const QList<QByteArray> &values);
+    void replace_string(const QString &dn, const QString &attribute, const QString &value);
+
+    bool is_empty() const;
+    QList<QString> get_dn_list() const;
+    QList<QString> get_attribute_list(const QString &dn) const;
+    QList<QByteArray> get_values(const QString &dn, const QString &attribute) const;
+
+private:
+    QList<QString> dn_list;
+    QHash<QString, QList<QString>> attribute_list_map;
+    QHash<QString, QHash<QString, QList<QByteArray>>> values_map;
+};
+
 class AdMessage {
 
 public:
@@ -114,6 +175,15 @@ public:
     bool logged_in_as_admin();
     QString get_dc() const;
 
+    // Sets a flag that is checked while waiting for search
+    // results. Once flag becomes non-zero, search in
+    // progress is abandoned on the server and search f-n
+    // returns failure. Flag should outlive this interface.
+    // Can be used to cancel searches running in another
+    // thread.
+    void set_cancel_flag(const QAtomicInt *flag);
+    bool is_cancelled() const;
+
     // NOTE: If request attributes list is empty, all
     // attributes are returned
 
@@ -129,20 +199,75 @@ public:
     // at once.
     bool search_paged(const QString &base, const SearchScope scope, const QString &filter, const QList<QString> &attributes, QHash<QString, AdObject> *results, AdCookie *cookie, const bool get_sacl = false);
 
+    // Performs multiple independent searches at the same
+    // time over one connection. Returns results in same
+    // order as args. Results of failed searches are empty.
+    // This is faster than doing searches one by one
+    // because requests are pipelined, so server can
+    // process them while we parse results of others.
+    QList<QHash<QString, AdObject>> search_concurrent(const QList<AdSearchArgs> &args_list);
+
+    // Searches for a window of objects in the order of
+    // sort attribute, using server-side sort and virtual
+    // list view controls. Only the requested window is
+    // transferred, so this is useful for containers with
+    // a huge amount of objects. Offset is the 0-based
+    // position of first object in the sorted list.
+    // Outputs objects in sorted order. Pass same context
+    // for all windows of one search, it is updated with
+    // state returned by server, including the total
+    // number of objects matching the search. Returns
+    // false if search failed or if server doesn't support
+    // the controls.
+    bool search_vlv(const QString &base, const SearchScope scope, const QString &filter, const QList<QString> &attributes, const QString &sort_attribute, const int offset, const int count, QList<AdObject> *results, AdVlvContext *context);
+
     // Simplest search f-n that only searches for attributes
     // of one object
     AdObject search_object(const QString &dn, const QList<QString> &attributes = QList<QString>(), const bool get_sacl = false);
 
+    // Searches for multiple objects at once. Returns map
+    // of DN => object. Objects that weren't found are not
+    // included. Use this instead of calling
+    // search_object() in a loop.
+    QHash<QString, AdObject> search_objects(const QList<QString> &dn_list, const QList<QString> &attributes = QList<QString>(), const bool get_sacl = false);
+
+    // Checks whether objects exist. Returns map of DN =>
+    // whether object exists. Object is considered to not
+    // exist only if server replied with noSuchObject. DNs
+    // for which the check failed for other reasons are not
+    // included.
+    QHash<QString, bool> objects_exist(const QList<QString> &dn_list);
+
+    // NOTE: to make messages, old values are read from
+    // the server before modifying. If messages are turned
+    // off then old values are not read and modify result
+    // alone decides success, which is useful for bulk
+    // operations. If caller already knows old values it
+    // can pass them to the overload to avoid the read.
     bool attribute_replace_values(const QString &dn, const QString &attribute, const QList<QByteArray> &values, const DoStatusMsg do_msg = DoStatusMsg_Yes);
+    bool attribute_replace_values(const QString &dn, const QString &attribute, const QList<QByteArray> &values, const QList<QByteArray> &old_values, const DoStatusMsg do_msg = DoStatusMsg_Yes);
 
     bool attribute_replace_value(const QString &dn, const QString &attribute, const QByteArray &value, const DoStatusMsg do_msg = DoStatusMsg_Yes);
     bool attribute_add_value(const QString &dn, const QString &attribute, const QByteArray &value, const DoStatusMsg do_msg = DoStatusMsg_Yes);
     bool attribute_delete_value(const QString &dn, const QString &attribute, const QByteArray &value, const DoStatusMsg do_msg = DoStatusMsg_Yes);
 
     bool attribute_replace_string(const QString &dn, const QString &attribute, const QString &value, const DoStatusMsg do_msg = DoStatusMsg_Yes);
+    bool attribute_replace_string(const QString &dn, const QString &attribute, const QString &value, const QString &old_value, const DoStatusMsg do_msg = DoStatusMsg_Yes);
     bool attribute_replace_int(const QString &dn, const QString &attribute, const int value, const DoStatusMsg do_msg = DoStatusMsg_Yes);
     bool attribute_replace_datetime(const QString &dn, const QString &attribute, const QDateTime &datetime);
 
+    // Applies all changes in batch. All changes for one
+    // object are sent as one modify operation and
+    // operations for multiple objects are pipelined on
+    // the connection. Like attribute_replace_values(),
+    // attributes whose old and new values are both empty
+    // are skipped and messages contain old and new
+    // values, if messages are on. Outputs dn's of
+    // objects that failed to be modified into
+    // failed_list, if it's given. Returns true if all
+    // objects were modified successfully.
+    bool modify_batch(const AdModifyBatch &batch, QList<QString> *failed_list = nullptr, const DoStatusMsg do_msg = DoStatusMsg_Yes);
+
     // NOTE: attrs_map should contain attribute values
     // that will be added to the newly created object.
     // Note that it *must* contain a valid value for
@@ -153,6 +278,19 @@ public:
     bool object_add(const QString &dn, const QString &object_class);
 
     bool object_delete(const QString &dn, const DoStatusMsg do_msg = DoStatusMsg_Yes);
+
+    // Deletes multiple objects. Deletes are pipelined on
+    // the connection, with at most max_in_flight of them
+    // waiting for a reply at a time. on_result, if given,
+    // is called for each object as soon as it's result
+    // arrives, so that caller can update incrementally.
+    // If connection fails or server stops replying,
+    // deletes that were in flight have unknown outcome.
+    // on_result is not called for them and instead they
+    // are output into unknown_list, if it's given, so
+    // that caller can check whether they still exist.
+    // Returns dn's of objects that were deleted.
+    QList<QString> object_delete_list(const QList<QString> &dn_list, const std::function<void(const QString &, const bool)> &on_result = nullptr, const int max_in_flight = OBJECT_DELETE_LIST_MAX, const DoStatusMsg do_msg = DoStatusMsg_Yes, QList<QString> *unknown_list = nullptr);
     bool object_move(const QString &dn, const QString &new_container);
     bool object_rename(const QString &dn, const QString &new_name);
 
@@ -172,7 +310,27 @@ public:
     bool gpo_add(const QString &name, QString &dn_out);
     bool gpo_delete(const QString &dn, bool *deleted_object);
     bool gpo_check_perms(const QString &gpo, bool *ok);
+
+    // Checks perms of multiple GPO's at once. GPC objects
+    // must contain "gPCFileSysPath" and a security
+    // descriptor retrieved with SACL. GPT descriptors are
+    // read concurrently. Returns map of GPO dn => whether
+    // GPT perms match GPC perms. GPO's which couldn't be
+    // checked are not included.
+    QHash<QString, bool> gpo_check_perms_list(const QList<AdObject> &gpc_list);
     bool gpo_sync_perms(const QString &gpo);
+
+    // Version of gpo_sync_perms() for big GPT's. Contents
+    // of GPT are processed level by level, so parent
+    // folders are done before their contents, and paths
+    // of one level are processed concurrently. on_progress
+    // is called after each level with number of processed
+    // and total paths. If some paths fail, sync continues
+    // with the rest of GPT, skipping contents of failed
+    // folders. Failed paths are output to failed_list.
+    // Pass them as resume_list to a later call to continue
+    // sync from those paths instead of starting over.
+    bool gpo_sync_perms(const QString &gpo, const std::function<void(const int done, const int total)> &on_progress, QList<QString> *failed_list = nullptr, const QList<QString> &resume_list = QList<QString>());
     bool gpo_get_sysvol_version(const AdObject &gpc_object, int *version);
 
     QString filesys_path_to_smb_path(const QString &filesys_path) const;
@@ -181,6 +339,22 @@ private:
     AdInterfacePrivate *d;
 };
 
+// Returns hosts of domain controllers, ordered by
+// priority and weight of their SRV records. Results are
+// cached for the duration of the records' TTL.
 QList<QString> get_domain_hosts(const QString &domain, const QString &site);
 
+// Does DC discovery in the background to fill the cache
+// used by get_domain_hosts(). Call this as early as
+// possible at startup. Background lookup is waited for at
+// exit.
+void get_domain_hosts_prefetch(const QString &domain, const QString &site);
+
+void get_domain_hosts_clear_cache();
+
+// Returns number of DNS queries done by
+// get_domain_hosts(), which don't include results served
+// from cache
+int get_domain_hosts_query_count();
+
 #endif /* AD_INTERFACE_H */
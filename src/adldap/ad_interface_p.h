@@ -24,13 +24,52 @@
 #include <QCoreApplication>
 #include <QList>
 #include <QMutex>
+#include <QVector>
+#include <functional>
 
 class AdInterface;
 class AdConfig;
+class AdObjectBuilder;
+class QAtomicInt;
 class QString;
 typedef struct ldap LDAP;
+typedef struct ldapmsg LDAPMessage;
+struct berval;
 typedef struct _SMBCCTX SMBCCTX;
 
+// Bound LDAP connection which is not used by any
+// AdInterface at the moment and is waiting in the pool
+// to be reused
+class AdPooledConnection {
+public:
+    LDAP *ld;
+    QString domain;
+    QString principal;
+    QString dc;
+    QString client_user;
+    int generation;
+    qint64 connect_time;
+    qint64 release_time;
+};
+
+// File or folder inside GPT
+class AdGptEntry {
+public:
+    QString path;
+    bool is_dir;
+
+    // Root of GPT has depth of 0
+    int depth;
+};
+
+// Contents of one GPT folder
+class AdGptDirListing {
+public:
+    QList<AdGptEntry> entry_list;
+    bool open_failed = false;
+    bool read_failed = false;
+};
+
 class AdInterfacePrivate {
     Q_DECLARE_TR_FUNCTIONS(AdInterfacePrivate)
 
@@ -43,23 +82,77 @@ public:
     LDAP *ld;
     bool is_connected;
     QString domain;
+    QString principal;
     QString dc;
     QString client_user;
     QList<AdMessage> messages;
+    const QAtomicInt *cancel_flag;
+
+    // Set when operations were abandoned or left without
+    // reading their replies. Such connections are not
+    // returned to the pool because stray replies could
+    // arrive later and be picked up by the next user.
+    bool has_pending_ops;
 
     void success_message(const QString &msg, const DoStatusMsg do_msg = DoStatusMsg_Yes);
     void error_message(const QString &context, const QString &error, const DoStatusMsg do_msg = DoStatusMsg_Yes);
     void error_message_plain(const QString &text, const DoStatusMsg do_msg = DoStatusMsg_Yes);
+    bool attribute_replace_values(const QString &dn, const QString &attribute, const QList<QByteArray> &values, const QList<QByteArray> *old_values, const DoStatusMsg do_msg);
     QString default_error() const;
+    QString default_error(const int ldap_result) const;
     int get_ldap_result() const;
+    bool is_cancelled() const;
+    int search_send(const char *base, const int scope, const char *filter, char **attributes, struct berval *cookie, const bool get_sacl, int *msgid);
+    void search_load_entry(LDAPMessage *entry, AdObjectBuilder *builder);
+    bool search_parse_result(LDAPMessage *res, struct berval **new_cookie);
+    LDAPMessage *search_receive(const int msgid, AdObjectBuilder *builder);
+    void search_log(const QString &base, const SearchScope scope, const QString &filter, const QList<QString> &attributes);
     bool search_paged_internal(const char *base, const int scope, const char *filter, char **attributes, QHash<QString, AdObject> *results, AdCookie *cookie, const bool get_sacl);
     bool connect_via_ldap(const char *uri);
     bool delete_gpt(const QString &parent_path);
-    bool smb_path_is_dir(const QString &path, bool *ok);
 
     // Returns GPT contents including the root path, in
     // order of increasing depth, so root path is first
-    QList<QString> gpo_get_gpt_contents(const QString &gpt_root_path, bool *ok);
+    QList<AdGptEntry> gpo_get_gpt_contents(const QString &gpt_root_path, bool *ok);
+
+    // Lists given folders concurrently, using multiple
+    // SMB contexts. Listings are in same order as folders.
+    static QVector<AdGptDirListing> gpt_list_dirs(const QList<QString> &dir_list);
+
+    // Calls f for each index in [0, count) using up to
+    // GPT_WALK_THREADS_MAX threads, each with it's own SMB
+    // context. Returns when all calls are done. Returns
+    // false without calling f if there's no context for
+    // current thread.
+    static bool smbc_run_concurrent(const int count, const std::function<void(SMBCCTX *context, const int i)> &f);
+
+    // Returns SMB context that current thread can use.
+    // Main thread gets the main context, other threads
+    // get a context from worker pool. Returns NULL if
+    // worker context couldn't be created. Context must
+    // be returned using smbc_context_put().
+    static SMBCCTX *smbc_context_take();
+    static void smbc_context_put(SMBCCTX *context);
+
+    // Pool of extra SMB contexts for walking GPT's in
+    // parallel. SMB context can only be used by one
+    // thread at a time, so each walker thread takes a
+    // context from the pool and returns it when done.
+    static SMBCCTX *smbc_worker_take();
+    static void smbc_worker_put(SMBCCTX *context);
+
+    // Connection pool. Bound connections are returned
+    // to the pool when AdInterface is destroyed and
+    // are then reused by following AdInterface's
+    // instead of doing the whole DNS lookup, init and
+    // bind sequence again. Each connection is leased
+    // exclusively, so one connection is never used by
+    // two AdInterface's (or threads) at the same time.
+    // Connections are only reused for same domain and
+    // principal as the ones they were bound with.
+    bool pool_take();
+    void pool_put();
+    static void pool_clear();
 
 private:
     static AdConfig *adconfig;
@@ -69,6 +162,12 @@ private:
     static int s_port;
     static CertStrategy s_cert_strat;
     static SMBCCTX *smbc;
+    static QMutex smbc_worker_mutex;
+    static QList<SMBCCTX *> smbc_worker_pool;
+    static QMutex pool_mutex;
+    static QList<AdPooledConnection> pool;
+    static int pool_generation;
+    qint64 connect_time;
     AdInterface *q;
 };
 
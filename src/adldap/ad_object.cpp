@@ -19,6 +19,7 @@
  */
 
 #include "ad_object.h"
+#include "ad_object_p.h"
 
 #include "ad_config.h"
 #include "ad_display.h"
@@ -35,81 +36,300 @@
 #include <QString>
 #include <algorithm>
 
+// Values bigger than this are not put into the shared
+// arena. This covers the common big values, like
+// security descriptors, photos and certificates.
+#define ARENA_VALUE_SIZE_MAX 512
+
+AdObjectBuilder::AdObjectBuilder() {
+}
+
+void AdObjectBuilder::begin_object(const QString &dn) {
+    current = new AdObjectData();
+    current->dn = dn;
+}
+
+void AdObjectBuilder::add_attribute(const char *name, const int name_size) {
+    // NOTE: lookup using raw data to avoid allocating a
+    // key for names that were already seen in this page
+    const QByteArray name_view = QByteArray::fromRawData(name, name_size);
+
+    AdObjectAttribute attribute;
+
+    // NOTE: attributes with options, like
+    // "member;range=0-1499", are not interned because
+    // options vary between searches and atoms are never
+    // freed
+    const bool has_options = (name_view.indexOf(';') != -1);
+    if (has_options) {
+        attribute.name = QString::fromUtf8(name, name_size);
+    } else {
+        AdAtom atom = atom_map.value(name_view);
+        if (atom.is_null()) {
+            const QByteArray name_copy(name, name_size);
+            atom = AdAtom::intern(QString::fromUtf8(name_copy));
+
+            atom_map.insert(name_copy, atom);
+        }
+
+        attribute.atom = atom;
+    }
+
+    attribute.value_start = current->value_list.size();
+    attribute.value_count = 0;
+
+    current->attribute_list.append(attribute);
+}
+
+void AdObjectBuilder::add_value(const char *data, const int size) {
+    AdObjectValueSpan span;
+    span.size = size;
+    span.is_large = (size > ARENA_VALUE_SIZE_MAX);
+
+    if (span.is_large) {
+        span.offset = current->large_value_list.size();
+        current->large_value_list.append(QByteArray(data, size));
+    } else {
+        span.offset = arena.size();
+        arena.append(data, size);
+    }
+
+    current->value_list.append(span);
+    current->attribute_list.last().value_count++;
+}
+
+void AdObjectBuilder::end_object() {
+    std::sort(current->attribute_list.begin(), current->attribute_list.end(),
+        [](const AdObjectAttribute &a, const AdObjectAttribute &b) {
+            return (a.atom.id() < b.atom.id());
+        });
+
+    current->attribute_list.squeeze();
+    current->value_list.squeeze();
+
+    object_list.append(current);
+    current.reset();
+}
+
+void AdObjectBuilder::finish(QHash<QString, AdObject> *results) {
+    QList<AdObject> object_list_out;
+    finish(&object_list_out);
+
+    for (const AdObject &object : object_list_out) {
+        results->insert(object.get_dn(), object);
+    }
+}
+
+void AdObjectBuilder::finish(QList<AdObject> *results) {
+    for (QExplicitlySharedDataPointer<AdObjectData> &data : object_list) {
+        data->arena = arena;
+
+        AdObject object;
+        object.d = data;
+
+        results->append(object);
+    }
+
+    arena = QByteArray();
+    object_list.clear();
+    atom_map.clear();
+}
+
 AdObject::AdObject() {
 }
 
+AdObject::AdObject(const AdObject &other)
+: d(other.d) {
+}
+
+AdObject &AdObject::operator=(const AdObject &other) {
+    d = other.d;
+
+    return *this;
+}
+
+AdObject::~AdObject() {
+}
+
 void AdObject::load(const QString &dn_arg, const QHash<QString, QList<QByteArray>> &attributes_data_arg) {
-    dn = dn_arg;
-    attributes_data = attributes_data_arg;
+    AdObjectBuilder builder;
+
+    builder.begin_object(dn_arg);
+
+    for (const QString &attribute : attributes_data_arg.keys()) {
+        const QByteArray attribute_bytes = attribute.toUtf8();
+        builder.add_attribute(attribute_bytes.constData(), attribute_bytes.size());
+
+        const QList<QByteArray> values = attributes_data_arg[attribute];
+        for (const QByteArray &value : values) {
+            builder.add_value(value.constData(), value.size());
+        }
+    }
+
+    builder.end_object();
+
+    QHash<QString, AdObject> results;
+    builder.finish(&results);
+
+    d = results[dn_arg].d;
 }
 
 QString AdObject::get_dn() const {
-    return dn;
+    if (d) {
+        return d->dn;
+    } else {
+        return QString();
+    }
 }
 
 QHash<QString, QList<QByteArray>> AdObject::get_attributes_data() const {
-    return attributes_data;
+    QHash<QString, QList<QByteArray>> out;
+
+    if (d) {
+        for (const AdObjectAttribute &attribute : d->attribute_list) {
+            out[attribute_name(attribute)] = values_of(&attribute);
+        }
+    }
+
+    return out;
 }
 
 bool AdObject::is_empty() const {
-    return attributes_data.isEmpty();
+    return (!d || d->attribute_list.isEmpty());
 }
 
 bool AdObject::contains(const QString &attribute) const {
-    return attributes_data.contains(attribute);
+    return (find_attribute(attribute) != nullptr);
+}
+
+bool AdObject::contains(const AdAtom &attribute) const {
+    return (find_attribute(attribute) != nullptr);
 }
 
 QList<QString> AdObject::attributes() const {
-    return attributes_data.keys();
+    QList<QString> out;
+
+    if (d) {
+        for (const AdObjectAttribute &attribute : d->attribute_list) {
+            out.append(attribute_name(attribute));
+        }
+    }
+
+    return out;
 }
 
 QList<QByteArray> AdObject::get_values(const QString &attribute) const {
-    if (contains(attribute)) {
-        return attributes_data[attribute];
-    } else {
-        return QList<QByteArray>();
+    return values_of(find_attribute(attribute));
+}
+
+QList<QByteArray> AdObject::get_values(const AdAtom &attribute) const {
+    return values_of(find_attribute(attribute));
+}
+
+QList<QByteArray> AdObject::values_of(const AdObjectAttribute *attribute_ptr) const {
+    QList<QByteArray> out;
+
+    if (attribute_ptr != nullptr) {
+        out.reserve(attribute_ptr->value_count);
+
+        // NOTE: values are copied out of the arena
+        // because caller may outlive this object
+        for (int i = 0; i < attribute_ptr->value_count; i++) {
+            const QByteArray view = get_value_view(attribute_ptr, i);
+            const QByteArray value(view.constData(), view.size());
+
+            out.append(value);
+        }
     }
+
+    return out;
 }
 
 QByteArray AdObject::get_value(const QString &attribute) const {
-    const QList<QByteArray> values = get_values(attribute);
+    return value_of(find_attribute(attribute));
+}
+
+QByteArray AdObject::get_value(const AdAtom &attribute) const {
+    return value_of(find_attribute(attribute));
+}
 
-    if (!values.isEmpty()) {
-        return values.first();
+QByteArray AdObject::value_of(const AdObjectAttribute *attribute_ptr) const {
+    if (attribute_ptr != nullptr && attribute_ptr->value_count > 0) {
+        const QByteArray view = get_value_view(attribute_ptr, 0);
+
+        return QByteArray(view.constData(), view.size());
     } else {
         return QByteArray();
     }
 }
 
 QList<QString> AdObject::get_strings(const QString &attribute) const {
-    const QList<QByteArray> values = get_values(attribute);
+    return strings_of(find_attribute(attribute));
+}
 
+QList<QString> AdObject::get_strings(const AdAtom &attribute) const {
+    return strings_of(find_attribute(attribute));
+}
+
+QList<QString> AdObject::strings_of(const AdObjectAttribute *attribute_ptr) const {
     QList<QString> strings;
-    for (const auto &value : values) {
-        const QString string = QString(value);
-        strings.append(string);
+
+    if (attribute_ptr != nullptr) {
+        strings.reserve(attribute_ptr->value_count);
+
+        for (int i = 0; i < attribute_ptr->value_count; i++) {
+            const QByteArray view = get_value_view(attribute_ptr, i);
+
+            // NOTE: stop at first null char, same as
+            // QString(QByteArray) conversion
+            const QString string = QString::fromUtf8(view.constData(), qstrnlen(view.constData(), view.size()));
+            strings.append(string);
+        }
     }
 
     return strings;
 }
 
 QString AdObject::get_string(const QString &attribute) const {
-    const QList<QString> strings = get_strings(attribute);
+    return string_of(find_attribute(attribute));
+}
+
+QString AdObject::get_string(const AdAtom &attribute) const {
+    return string_of(find_attribute(attribute));
+}
+
+QString AdObject::string_of(const AdObjectAttribute *attribute_ptr) const {
+    static const AdAtom object_class_atom = AdAtom::intern(ATTRIBUTE_OBJECT_CLASS);
+
+    if (attribute_ptr == nullptr || attribute_ptr->value_count == 0) {
+        return QString();
+    }
 
     // NOTE: return last object class because that is the most derived one and is what's needed most of the time
-    if (!strings.isEmpty()) {
-        if (attribute == ATTRIBUTE_OBJECT_CLASS) {
-            return strings.last();
+    const int value_i = [&]() {
+        if (attribute_ptr->atom == object_class_atom) {
+            return attribute_ptr->value_count - 1;
         } else {
-            return strings.first();
+            return 0;
         }
-    } else {
-        return QString();
-    }
+    }();
+
+    const QByteArray view = get_value_view(attribute_ptr, value_i);
+    const QString string = QString::fromUtf8(view.constData(), qstrnlen(view.constData(), view.size()));
+
+    return string;
 }
 
 QList<int> AdObject::get_ints(const QString &attribute) const {
-    const QList<QString> strings = get_strings(attribute);
+    return ints_of(find_attribute(attribute));
+}
+
+QList<int> AdObject::get_ints(const AdAtom &attribute) const {
+    return ints_of(find_attribute(attribute));
+}
+
+QList<int> AdObject::ints_of(const AdObjectAttribute *attribute_ptr) const {
+    const QList<QString> strings = strings_of(attribute_ptr);
 
     QList<int> ints;
     for (const auto &string : strings) {
@@ -121,7 +341,15 @@ QList<int> AdObject::get_ints(const QString &attribute) const {
 }
 
 int AdObject::get_int(const QString &attribute) const {
-    const QList<int> ints = get_ints(attribute);
+    return int_of(find_attribute(attribute));
+}
+
+int AdObject::get_int(const AdAtom &attribute) const {
+    return int_of(find_attribute(attribute));
+}
+
+int AdObject::int_of(const AdObjectAttribute *attribute_ptr) const {
+    const QList<int> ints = ints_of(attribute_ptr);
 
     if (!ints.isEmpty()) {
         return ints.first();
@@ -269,8 +497,83 @@ security_descriptor *AdObject::get_security_descriptor(TALLOC_CTX *mem_ctx_arg)
         }
     }();
 
-    const QByteArray sd_bytes = get_value(ATTRIBUTE_SECURITY_DESCRIPTOR);
+    // NOTE: using a view is fine here because the bytes
+    // are only used while this object is alive
+    static const AdAtom sd_atom = AdAtom::intern(ATTRIBUTE_SECURITY_DESCRIPTOR);
+    const AdObjectAttribute *sd_attribute = find_attribute(sd_atom);
+    const QByteArray sd_bytes = [&]() {
+        if (sd_attribute != nullptr && sd_attribute->value_count > 0) {
+            return get_value_view(sd_attribute, 0);
+        } else {
+            return QByteArray();
+        }
+    }();
     security_descriptor *out = security_descriptor_make_from_bytes(mem_ctx, sd_bytes);
 
     return out;
 }
+
+const AdObjectAttribute *AdObject::find_attribute(const AdAtom &attribute) const {
+    if (!d || attribute.is_null()) {
+        return nullptr;
+    }
+
+    const QVector<AdObjectAttribute> &attribute_list = d->attribute_list;
+
+    auto it = std::lower_bound(attribute_list.cbegin(), attribute_list.cend(), attribute.id(),
+        [](const AdObjectAttribute &a, const int id) {
+            return (a.atom.id() < id);
+        });
+
+    if (it != attribute_list.cend() && it->atom == attribute) {
+        return &(*it);
+    } else {
+        return nullptr;
+    }
+}
+
+// NOTE: names that were never interned can only belong to
+// attributes with options, which are not sorted by atom,
+// so those are searched linearly
+const AdObjectAttribute *AdObject::find_attribute(const QString &attribute) const {
+    if (!d) {
+        return nullptr;
+    }
+
+    const AdAtom atom = AdAtom::find(attribute);
+    if (!atom.is_null()) {
+        return find_attribute(atom);
+    }
+
+    for (const AdObjectAttribute &attribute_data : d->attribute_list) {
+        if (attribute_data.atom.is_null() && attribute_data.name == attribute) {
+            return &attribute_data;
+        }
+    }
+
+    return nullptr;
+}
+
+QString AdObject::attribute_name(const AdObjectAttribute &attribute) {
+    if (attribute.atom.is_null()) {
+        return attribute.name;
+    } else {
+        return attribute.atom.name();
+    }
+}
+
+// NOTE: returned array may not own it's data and point
+// into the arena, so it must not outlive this object
+QByteArray AdObject::get_value_view(const AdObjectAttribute *attribute, const int i) const {
+    const AdObjectValueSpan &span = d->value_list[attribute->value_start + i];
+
+    // NOTE: large values are returned as is, they are
+    // implicitly shared so this doesn't copy them
+    if (span.is_large) {
+        return d->large_value_list[span.offset];
+    }
+
+    const char *data = d->arena.constData() + span.offset;
+
+    return QByteArray::fromRawData(data, span.size);
+}
@@ -36,10 +36,14 @@
 #include <QByteArray>
 #include <QHash>
 #include <QList>
+#include <QSharedDataPointer>
 #include <QString>
 
 class QDateTime;
 class AdConfig;
+class AdAtom;
+class AdObjectData;
+class AdObjectAttribute;
 typedef void TALLOC_CTX;
 struct security_descriptor;
 
@@ -47,6 +51,9 @@ class AdObject {
 
 public:
     AdObject();
+    AdObject(const AdObject &other);
+    AdObject &operator=(const AdObject &other);
+    ~AdObject();
 
     void load(const QString &dn_arg, const QHash<QString, QList<QByteArray>> &attributes_data_arg);
 
@@ -54,16 +61,26 @@ public:
     QHash<QString, QList<QByteArray>> get_attributes_data() const;
     bool is_empty() const;
     bool contains(const QString &attribute) const;
+    bool contains(const AdAtom &attribute) const;
     QList<QString> attributes() const;
 
+    // NOTE: overloads that accept atoms are faster than
+    // the ones that accept strings, use them in hot paths
+
     QList<QByteArray> get_values(const QString &attribute) const;
+    QList<QByteArray> get_values(const AdAtom &attribute) const;
     QByteArray get_value(const QString &attribute) const;
+    QByteArray get_value(const AdAtom &attribute) const;
 
     QList<QString> get_strings(const QString &attribute) const;
+    QList<QString> get_strings(const AdAtom &attribute) const;
     QString get_string(const QString &attribute) const;
+    QString get_string(const AdAtom &attribute) const;
 
     int get_int(const QString &attribute) const;
+    int get_int(const AdAtom &attribute) const;
     QList<int> get_ints(const QString &attribute) const;
+    QList<int> get_ints(const AdAtom &attribute) const;
 
     QList<bool> get_bools(const QString &attribute) const;
     bool get_bool(const QString &attribute) const;
@@ -88,8 +105,20 @@ public:
     security_descriptor *get_security_descriptor(TALLOC_CTX *mem_ctx = nullptr) const;
 
 private:
-    QString dn;
-    QHash<QString, QList<QByteArray>> attributes_data;
+    QExplicitlySharedDataPointer<AdObjectData> d;
+
+    const AdObjectAttribute *find_attribute(const AdAtom &attribute) const;
+    const AdObjectAttribute *find_attribute(const QString &attribute) const;
+    QList<QByteArray> values_of(const AdObjectAttribute *attribute_ptr) const;
+    QByteArray value_of(const AdObjectAttribute *attribute_ptr) const;
+    QList<QString> strings_of(const AdObjectAttribute *attribute_ptr) const;
+    QString string_of(const AdObjectAttribute *attribute_ptr) const;
+    QList<int> ints_of(const AdObjectAttribute *attribute_ptr) const;
+    int int_of(const AdObjectAttribute *attribute_ptr) const;
+    static QString attribute_name(const AdObjectAttribute &attribute);
+    QByteArray get_value_view(const AdObjectAttribute *attribute, const int i) const;
+
+    friend class AdObjectBuilder;
 };
 
 #endif /* AD_OBJECT_H */
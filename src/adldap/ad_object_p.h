@@ -0,0 +1,106 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AD_OBJECT_P_H
+#define AD_OBJECT_P_H
+
+#include "ad_atom.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QSharedData>
+#include <QString>
+#include <QVector>
+
+class AdObject;
+
+// Location of one value. Small values are inside the
+// arena, at offset. Large values are in the object's own
+// large value list, at offset as index.
+class AdObjectValueSpan {
+public:
+    int offset;
+    int size;
+    bool is_large;
+};
+
+// Attribute of an object. Values of the attribute are
+// value_count consecutive spans starting at value_start.
+// Attributes with options are not interned, for them atom
+// is null and name is set instead.
+class AdObjectAttribute {
+public:
+    AdAtom atom;
+    QString name;
+    int value_start;
+    int value_count;
+};
+
+// NOTE: small values of all objects that were loaded by
+// the same search page are stored in one shared arena, so
+// an object doesn't own separate allocations for each
+// value. Large values are stored separately by each
+// object, so that an object which outlives others from
+// it's page doesn't keep their large values alive.
+// Attribute list is sorted by atom id for lookups, with
+// attributes that have no atom at the front.
+class AdObjectData : public QSharedData {
+public:
+    QString dn;
+    QByteArray arena;
+    QVector<AdObjectAttribute> attribute_list;
+    QVector<AdObjectValueSpan> value_list;
+    QList<QByteArray> large_value_list;
+};
+
+// Builds objects for one search page. Entries are added
+// as they arrive from the server and objects are created
+// once the page is complete, at which point they all
+// share the arena of this page.
+class AdObjectBuilder {
+public:
+    AdObjectBuilder();
+
+    void begin_object(const QString &dn);
+    void add_attribute(const char *name, const int name_size);
+    void add_value(const char *data, const int size);
+    void end_object();
+
+    // Outputs objects built so far and resets builder to
+    // be used for the next page
+    void finish(QHash<QString, AdObject> *results);
+
+    // Same as above but preserves order in which objects
+    // were received
+    void finish(QList<AdObject> *results);
+
+private:
+    QByteArray arena;
+    QList<QExplicitlySharedDataPointer<AdObjectData>> object_list;
+    QExplicitlySharedDataPointer<AdObjectData> current;
+
+    // Cache of name => atom for this page, to avoid
+    // going through the global atom table for every
+    // attribute of every object
+    QHash<QByteArray, AdAtom> atom_map;
+};
+
+#endif /* AD_OBJECT_P_H */
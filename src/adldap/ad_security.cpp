@@ -30,6 +30,7 @@
 #include "ad_filter.h"
 
 #include <QDebug>
+#include <QMutex>
 
 #define UNUSED_ARG(x) (void) (x)
 
@@ -51,6 +52,15 @@ int ace_compare_simplified(const security_ace &ace1, const security_ace &ace2);
 void security_descriptor_add_right_base(security_descriptor *sd, const QByteArray &trustee, const uint32_t access_mask, const QByteArray &object_type, const bool allow);
 void security_descriptor_remove_right_base(security_descriptor *sd, const QByteArray &trustee, const uint32_t access_mask, const QByteArray &object_type, const bool allow);
 
+// Max amount of sid's in one trustee name search filter
+#define TRUSTEE_NAME_SEARCH_BATCH_SIZE 50
+
+// Names of trustees that were found by searching. Shared
+// by all users of trustee names for the whole session.
+// Key is sid string.
+QMutex trustee_name_cache_mutex;
+QHash<QString, QString> trustee_name_cache;
+
 const QList<int> ace_types_with_object = {
     SEC_ACE_TYPE_ACCESS_ALLOWED_OBJECT,
     SEC_ACE_TYPE_ACCESS_DENIED_OBJECT,
@@ -204,25 +214,75 @@ QString ad_security_get_well_known_trustee_name(const QByteArray &trustee) {
 }
 
 QString ad_security_get_trustee_name(AdInterface &ad, const QByteArray &trustee) {
-    const QString trustee_string = object_sid_display_value(trustee);
+    const QHash<QByteArray, QString> name_map = ad_security_get_trustee_name_list(ad, {trustee});
+    const QString out = name_map.value(trustee);
+
+    return out;
+}
+
+QHash<QByteArray, QString> ad_security_get_trustee_name_list(AdInterface &ad, const QList<QByteArray> &trustee_list) {
+    QHash<QByteArray, QString> out;
+
+    // Get names that are well known or were already
+    // resolved during this session. Collect the rest for
+    // searching.
+    QHash<QString, QByteArray> unresolved_map;
+    {
+        QMutexLocker locker(&trustee_name_cache_mutex);
+
+        for (const QByteArray &trustee : trustee_list) {
+            const QString trustee_string = object_sid_display_value(trustee);
+
+            if (trustee_name_map.contains(trustee_string)) {
+                out[trustee] = trustee_name_map[trustee_string];
+            } else if (trustee_name_cache.contains(trustee_string)) {
+                out[trustee] = trustee_name_cache[trustee_string];
+            } else {
+                unresolved_map[trustee_string] = trustee;
+            }
+        }
+    }
+
+    if (unresolved_map.isEmpty()) {
+        return out;
+    }
+
+    // Try to get names of trustees by finding their
+    // objects. Search for multiple sid's at once to
+    // reduce the amount of requests.
+    const QList<QString> unresolved_list = unresolved_map.keys();
+    const QList<QString> attributes = {
+        ATTRIBUTE_OBJECT_SID,
+        ATTRIBUTE_DISPLAY_NAME,
+        ATTRIBUTE_SAM_ACCOUNT_NAME,
+    };
+
+    QHash<QString, QString> found_name_map;
+
+    for (int i = 0; i < unresolved_list.size(); i += TRUSTEE_NAME_SEARCH_BATCH_SIZE) {
+        const QList<QString> batch = unresolved_list.mid(i, TRUSTEE_NAME_SEARCH_BATCH_SIZE);
+
+        const QString filter = [&]() {
+            QList<QString> subfilter_list;
+
+            for (const QString &trustee_string : batch) {
+                const QString subfilter = filter_CONDITION(Condition_Equals, ATTRIBUTE_OBJECT_SID, trustee_string);
+                subfilter_list.append(subfilter);
+            }
+
+            return filter_OR(subfilter_list);
+        }();
+
+        const QHash<QString, AdObject> results = ad.search(ad.adconfig()->domain_dn(), SearchScope_All, filter, attributes);
+
+        for (const AdObject &object : results.values()) {
+            const QByteArray object_sid = object.get_value(ATTRIBUTE_OBJECT_SID);
+            const QString object_sid_string = object_sid_display_value(object_sid);
 
-    if (trustee_name_map.contains(trustee_string)) {
-        return trustee_name_map[trustee_string];
-    } else {
-        // Try to get name of trustee by finding it's DN
-        const QString filter = filter_CONDITION(Condition_Equals, ATTRIBUTE_OBJECT_SID, trustee_string);
-        const QList<QString> attributes = {
-            ATTRIBUTE_DISPLAY_NAME,
-            ATTRIBUTE_SAM_ACCOUNT_NAME,
-        };
-        const auto trustee_search = ad.search(ad.adconfig()->domain_dn(), SearchScope_All, filter, QList<QString>());
-        if (!trustee_search.isEmpty()) {
             // NOTE: this is some weird name selection logic
             // but that's how microsoft does it. Maybe need
             // to use this somewhere else as well?
             const QString name = [&]() {
-                const AdObject object = trustee_search.values()[0];
-
                 if (object.contains(ATTRIBUTE_DISPLAY_NAME)) {
                     return object.get_string(ATTRIBUTE_DISPLAY_NAME);
                 } else if (object.contains(ATTRIBUTE_SAM_ACCOUNT_NAME)) {
@@ -232,12 +292,33 @@ QString ad_security_get_trustee_name(AdInterface &ad, const QByteArray &trustee)
                 }
             }();
 
-            return name;
+            found_name_map[object_sid_string] = name;
+        }
+    }
+
+    QMutexLocker locker(&trustee_name_cache_mutex);
+
+    for (const QString &trustee_string : unresolved_list) {
+        const QByteArray trustee = unresolved_map[trustee_string];
+
+        // NOTE: only cache names that were found. Return
+        // raw sid as last option.
+        if (found_name_map.contains(trustee_string)) {
+            const QString name = found_name_map[trustee_string];
+
+            trustee_name_cache[trustee_string] = name;
+            out[trustee] = name;
         } else {
-            // Return raw sid as last option
-            return trustee_string;
+            out[trustee] = trustee_string;
         }
     }
+
+    return out;
+}
+
+void ad_security_clear_trustee_name_cache() {
+    QMutexLocker locker(&trustee_name_cache_mutex);
+    trustee_name_cache.clear();
 }
 
 bool ad_security_replace_security_descriptor(AdInterface &ad, const QString &dn, security_descriptor *new_sd) {
@@ -277,7 +358,7 @@ dom_sid dom_sid_from_bytes(const QByteArray &bytes) {
 
 QByteArray dom_sid_string_to_bytes(const QString &string) {
     dom_sid sid;
-    dom_sid_parse(cstr(string), &sid);
+    dom_sid_parse(CStr(string), &sid);
     const QByteArray bytes = dom_sid_to_bytes(sid);
 
     return bytes;
@@ -450,82 +531,109 @@ QList<security_ace> security_descriptor_get_dacl(const security_descriptor *sd)
     return out;
 }
 
-SecurityRightState security_descriptor_get_right(const security_descriptor *sd, const QByteArray &trustee, const uint32_t access_mask_arg, const QByteArray &object_type) {
-    bool out_data[SecurityRightStateInherited_COUNT][SecurityRightStateType_COUNT];
+SecurityRightState security_descriptor_get_right(const security_descriptor *sd, const QByteArray &trustee, const uint32_t access_mask, const QByteArray &object_type) {
+    const SecurityRightIndex index = SecurityRightIndex(sd, trustee);
+    const SecurityRightState out = index.get(access_mask, object_type);
 
-    const uint32_t access_mask = ad_security_map_access_mask(access_mask_arg);
+    return out;
+}
 
-    for (int x = 0; x < SecurityRightStateInherited_COUNT; x++) {
-        for (int y = 0; y < SecurityRightStateType_COUNT; y++) {
-            out_data[x][y] = false;
-        }
-    }
+SecurityRightIndex::SecurityRightIndex(const security_descriptor *sd, const QByteArray &trustee) {
+    const dom_sid trustee_sid = dom_sid_from_bytes(trustee);
 
     const QList<security_ace> dacl = security_descriptor_get_dacl(sd);
 
     for (const security_ace &ace : dacl) {
-        const bool match = [&]() {
-            const bool trustee_match = [&]() {
-                const dom_sid trustee_sid = dom_sid_from_bytes(trustee);
-                const bool trustees_are_equal = (dom_sid_compare(&ace.trustee, &trustee_sid) == 0);
-
-                return trustees_are_equal;
-            }();
+        const bool trustee_match = (dom_sid_compare(&ace.trustee, &trustee_sid) == 0);
+        if (!trustee_match) {
+            continue;
+        }
 
-            const bool access_mask_match = bitmask_is_set(ace.access_mask, access_mask);
+        // NOTE: ace's that are neither allow or deny (audit
+        // for example) don't affect right state
+        const int type_i = [&]() {
+            if (ace_type_allow_set.contains(ace.type)) {
+                return (int) SecurityRightStateType_Allow;
+            } else if (ace_type_deny_set.contains(ace.type)) {
+                return (int) SecurityRightStateType_Deny;
+            } else {
+                return -1;
+            }
+        }();
+        if (type_i == -1) {
+            continue;
+        }
 
-            const bool object_match = [&]() {
-                const bool object_present = ace_types_with_object.contains(ace.type);
+        const int inherit_i = [&]() {
+            const bool ace_is_inherited = bitmask_is_set(ace.flags, SEC_ACE_FLAG_INHERITED_ACE);
 
-                if (object_present) {
-                    const GUID out_guid = ace.object.object.type.type;
-                    const QByteArray ace_object_type = QByteArray((char *) &out_guid, sizeof(GUID));
-                    const bool types_are_equal = (ace_object_type == object_type);
+            if (ace_is_inherited) {
+                return SecurityRightStateInherited_Yes;
+            } else {
+                return SecurityRightStateInherited_No;
+            }
+        }();
 
-                    return types_are_equal;
-                } else {
-                    // NOTE: if compared ace doesn't
-                    // have an object it can still
-                    // match if it's access mask
-                    // matches with given ace. Example:
-                    // ace that allows "generic read"
-                    // (mask contains bit for "read
-                    // property" and object is empty)
-                    // will also allow right for
-                    // reading personal info (mask *is*
-                    // "read property" and contains
-                    // some object)
-                    return access_mask_match;
-                }
-            }();
+        SecurityRightMaskTable &table = [&]() -> SecurityRightMaskTable & {
+            const bool object_present = ace_types_with_object.contains(ace.type);
 
-            const bool out = (trustee_match && access_mask_match && object_match);
+            if (object_present) {
+                const GUID ace_object_type_guid = ace.object.object.type.type;
+                const QByteArray ace_object_type = QByteArray((char *) &ace_object_type_guid, sizeof(GUID));
 
-            return out;
+                return object_table_map[ace_object_type];
+            } else {
+                return no_object_table;
+            }
         }();
 
-        if (match) {
-            bool state_list[2];
-            state_list[SecurityRightStateType_Allow] = ace_type_allow_set.contains(ace.type);
-            state_list[SecurityRightStateType_Deny] = ace_type_deny_set.contains(ace.type);
+        QList<uint32_t> &mask_list = table.mask_list[inherit_i][type_i];
+        if (!mask_list.contains(ace.access_mask)) {
+            mask_list.append(ace.access_mask);
+        }
+    }
+}
 
-            const int inherit_i = [&]() {
-                const bool ace_is_inherited = bitmask_is_set(ace.flags, SEC_ACE_FLAG_INHERITED_ACE);
+SecurityRightState SecurityRightIndex::get(const uint32_t access_mask_arg, const QByteArray &object_type) const {
+    const uint32_t access_mask = ad_security_map_access_mask(access_mask_arg);
 
-                if (ace_is_inherited) {
-                    return SecurityRightStateInherited_Yes;
-                } else {
-                    return SecurityRightStateInherited_No;
-                }
-            }();
+    // NOTE: if ace doesn't have an object it can still
+    // match if it's access mask matches. Example: ace
+    // that allows "generic read" (mask contains bit for
+    // "read property" and object is empty) will also
+    // allow right for reading personal info (mask *is*
+    // "read property" and contains some object)
+    const SecurityRightMaskTable *object_table = [&]() -> const SecurityRightMaskTable * {
+        auto it = object_table_map.find(object_type);
+
+        if (it != object_table_map.end()) {
+            return &it.value();
+        } else {
+            return nullptr;
+        }
+    }();
 
-            for (int type_i = 0; type_i < SecurityRightStateType_COUNT; type_i++) {
-                const bool right_state = state_list[type_i];
+    const QList<const SecurityRightMaskTable *> table_list = {&no_object_table, object_table};
 
-                if (right_state) {
-                    out_data[inherit_i][type_i] = true;
+    bool out_data[SecurityRightStateInherited_COUNT][SecurityRightStateType_COUNT];
+
+    for (int inherit_i = 0; inherit_i < SecurityRightStateInherited_COUNT; inherit_i++) {
+        for (int type_i = 0; type_i < SecurityRightStateType_COUNT; type_i++) {
+            out_data[inherit_i][type_i] = [&]() {
+                for (const SecurityRightMaskTable *table : table_list) {
+                    if (table == nullptr) {
+                        continue;
+                    }
+
+                    for (const uint32_t ace_mask : table->mask_list[inherit_i][type_i]) {
+                        if (bitmask_is_set(ace_mask, access_mask)) {
+                            return true;
+                        }
+                    }
                 }
-            }
+
+                return false;
+            }();
         }
     }
 
@@ -537,10 +645,20 @@ SecurityRightState security_descriptor_get_right(const security_descriptor *sd,
 void security_descriptor_print(security_descriptor *sd, AdInterface &ad) {
     const QList<security_ace> dacl = security_descriptor_get_dacl(sd);
 
+    const QHash<QByteArray, QString> trustee_name_map_out = [&]() {
+        QList<QByteArray> trustee_list;
+
+        for (const security_ace &ace : dacl) {
+            trustee_list.append(dom_sid_to_bytes(ace.trustee));
+        }
+
+        return ad_security_get_trustee_name_list(ad, trustee_list);
+    }();
+
     for (const security_ace &ace : dacl) {
         qInfo() << "\nace:";
         const QByteArray trustee_sid = dom_sid_to_bytes(ace.trustee);
-        const QString trustee_name = ad_security_get_trustee_name(ad, trustee_sid);
+        const QString trustee_name = trustee_name_map_out.value(trustee_sid);
         qInfo() << "trustee:" << trustee_name;
         qInfo() << "mask:" << int_to_hex_string(ace.access_mask);
         qInfo() << "type:" << ace.type;
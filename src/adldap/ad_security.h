@@ -29,6 +29,7 @@
 #include "ad_defines.h"
 
 #include <QByteArray>
+#include <QHash>
 #include <QLocale>
 
 class AdInterface;
@@ -69,8 +70,47 @@ public:
     QByteArray object_type;
 };
 
+// Masks of matching ace's, grouped by inheritance and
+// type. Note that masks are not OR'd together because
+// a right matches only if a single ace contains all of
+// it's bits.
+class SecurityRightMaskTable {
+public:
+    QList<uint32_t> mask_list[SecurityRightStateInherited_COUNT][SecurityRightStateType_COUNT];
+};
+
+// Index of DACL rights of one trustee. Built once from
+// sd, after which rights can be looked up without going
+// through the whole DACL. Produces the same results as
+// security_descriptor_get_right(). Note that index
+// doesn't track changes to sd, so it needs to be
+// rebuilt after sd is modified.
+class SecurityRightIndex {
+public:
+    SecurityRightIndex(const security_descriptor *sd, const QByteArray &trustee);
+
+    SecurityRightState get(const uint32_t access_mask, const QByteArray &object_type) const;
+
+private:
+    // Ace's without object type, which match any object
+    // type
+    SecurityRightMaskTable no_object_table;
+
+    // Ace's with object type, keyed by object type guid
+    QHash<QByteArray, SecurityRightMaskTable> object_table_map;
+};
+
 QString ad_security_get_well_known_trustee_name(const QByteArray &trustee);
 QString ad_security_get_trustee_name(AdInterface &ad, const QByteArray &trustee);
+
+// Gets names of multiple trustees at once, using one
+// search for all trustees that are not well known.
+// Resolved names are cached for the whole session and
+// shared with ad_security_get_trustee_name(). Returns
+// map of trustee sid => name, with raw sid string as the
+// name for trustees that couldn't be found.
+QHash<QByteArray, QString> ad_security_get_trustee_name_list(AdInterface &ad, const QList<QByteArray> &trustee_list);
+void ad_security_clear_trustee_name_cache();
 bool ad_security_get_protected_against_deletion(const AdObject &object);
 bool ad_security_set_protected_against_deletion(AdInterface &ad, const QString dn, const bool enabled);
 bool ad_security_get_user_cant_change_pass(const AdObject *object, AdConfig *adconfig);
@@ -293,7 +293,7 @@ QString dn_move(const QString &dn, const QString &new_parent_dn) {
 // =>
 // "domain.com/bar/foo"
 QString dn_canonical(const QString &dn) {
-    char *canonical_cstr = ldap_dn2ad_canonical(cstr(dn));
+    char *canonical_cstr = ldap_dn2ad_canonical(CStr(dn));
     const QString canonical = QString(canonical_cstr);
     ldap_memfree(canonical_cstr);
 
@@ -316,7 +316,9 @@ QString dn_from_name_and_parent(const QString &name, const QString &parent, cons
     return dn;
 }
 
-QString get_default_domain_from_krb5() {
+// Returns either the realm or the full name of the
+// principal in default ccache
+static QString get_default_principal_string(const bool realm_only) {
     krb5_error_code result;
     krb5_context context;
     krb5_ccache default_cache;
@@ -348,7 +350,24 @@ QString get_default_domain_from_krb5() {
         return QString();
     }
 
-    const QString out = QString::fromLocal8Bit(default_principal->realm.data, default_principal->realm.length);
+    const QString out = [&]() {
+        if (realm_only) {
+            return QString::fromLocal8Bit(default_principal->realm.data, default_principal->realm.length);
+        }
+
+        char *name = NULL;
+        result = krb5_unparse_name(context, default_principal, &name);
+        if (result) {
+            qDebug() << "Failed to unparse default krb5 principal";
+
+            return QString();
+        }
+
+        const QString name_string = QString::fromLocal8Bit(name);
+        krb5_free_unparsed_name(context, name);
+
+        return name_string;
+    }();
 
     krb5_free_principal(context, default_principal);
     krb5_cc_close(context, default_cache);
@@ -357,6 +376,14 @@ QString get_default_domain_from_krb5() {
     return out;
 }
 
+QString get_default_domain_from_krb5() {
+    return get_default_principal_string(true);
+}
+
+QString get_default_principal_from_krb5() {
+    return get_default_principal_string(false);
+}
+
 int bitmask_set(const int input_mask, const int mask_to_set, const bool is_set) {
     if (is_set) {
         return input_mask | mask_to_set;
@@ -369,19 +396,102 @@ bool bitmask_is_set(const int input_mask, const int mask_to_read) {
     return ((input_mask & mask_to_read) == mask_to_read);
 }
 
-const char *cstr(const QString &qstr) {
-    static QList<QByteArray> buffer;
+// Decodes code point at given position and advances
+// position past it. Lone surrogates are replaced with
+// replacement character, same as toUtf8().
+static uint utf16_next(const ushort *in, const int in_size, int *i) {
+    uint c = in[*i];
+    (*i)++;
+
+    const bool is_surrogate_pair = (QChar::isHighSurrogate(c) && *i < in_size && QChar::isLowSurrogate(in[*i]));
+    if (is_surrogate_pair) {
+        c = QChar::surrogateToUcs4(c, in[*i]);
+        (*i)++;
+    } else if (QChar::isSurrogate(c)) {
+        c = QChar::ReplacementCharacter;
+    }
+
+    return c;
+}
 
-    const QByteArray bytes = qstr.toUtf8();
-    buffer.append(bytes);
+static int utf8_size(const uint c) {
+    if (c < 0x80) {
+        return 1;
+    } else if (c < 0x800) {
+        return 2;
+    } else if (c < 0x10000) {
+        return 3;
+    } else {
+        return 4;
+    }
+}
 
-    // Limit buffer to 100 strings
-    if (buffer.size() > 100) {
-        buffer.removeAt(0);
+CStr::CStr(const QString &string) {
+    // NOTE: encode UTF-16 to UTF-8 directly into the
+    // buffer instead of using toUtf8(), which always
+    // allocates. Exact size is computed first, so that
+    // buffer only goes to the heap if encoded string
+    // doesn't fit into the stack buffer.
+    const ushort *in = string.utf16();
+    const int in_size = string.size();
+
+    int out_size = 0;
+    for (int i = 0; i < in_size;) {
+        out_size += utf8_size(utf16_next(in, in_size, &i));
     }
 
-    // NOTE: return data of bytes in buffer NOT the temp local bytes
-    return buffer.last().constData();
+    // +1 for null terminator
+    buffer.resize(out_size + 1);
+
+    char *out = buffer.data();
+    int out_i = 0;
+
+    for (int i = 0; i < in_size;) {
+        const uint c = utf16_next(in, in_size, &i);
+
+        switch (utf8_size(c)) {
+            case 1: {
+                out[out_i++] = (char) c;
+
+                break;
+            }
+            case 2: {
+                out[out_i++] = (char) (0xC0 | (c >> 6));
+                out[out_i++] = (char) (0x80 | (c & 0x3F));
+
+                break;
+            }
+            case 3: {
+                out[out_i++] = (char) (0xE0 | (c >> 12));
+                out[out_i++] = (char) (0x80 | ((c >> 6) & 0x3F));
+                out[out_i++] = (char) (0x80 | (c & 0x3F));
+
+                break;
+            }
+            default: {
+                out[out_i++] = (char) (0xF0 | (c >> 18));
+                out[out_i++] = (char) (0x80 | ((c >> 12) & 0x3F));
+                out[out_i++] = (char) (0x80 | ((c >> 6) & 0x3F));
+                out[out_i++] = (char) (0x80 | (c & 0x3F));
+
+                break;
+            }
+        }
+    }
+
+    out[out_i] = '\0';
+}
+
+const char *CStr::get() const {
+    return buffer.constData();
+}
+
+int CStr::size() const {
+    return buffer.size() - 1;
+}
+
+char *CStr::data() {
+    return buffer.data();
 }
 
 bool load_adldap_translation(QTranslator &translator, const QLocale &locale) {
@@ -421,7 +531,7 @@ QByteArray guid_string_to_bytes(const QString &guid_string) {
 
 QByteArray sid_string_to_bytes(const QString &sid_string) {
     dom_sid sid;
-    string_to_sid(&sid, cstr(sid_string));
+    string_to_sid(&sid, CStr(sid_string));
 
     const QByteArray sid_bytes = QByteArray((char *) &sid, sizeof(dom_sid));
 
@@ -28,6 +28,8 @@
 
 #include "ad_defines.h"
 
+#include <QVarLengthArray>
+
 class QString;
 class QDateTime;
 class QByteArray;
@@ -64,15 +66,38 @@ QString dn_canonical(const QString &dn);
 QString dn_from_name_and_parent(const QString &name, const QString &parent, const QString &object_class);
 
 QString get_default_domain_from_krb5();
+QString get_default_principal_from_krb5();
 
 int bitmask_set(const int input_mask, const int mask_to_set, const bool is_set);
 bool bitmask_is_set(const int input_mask, const int mask_to_read);
 
-// NOTE: uses a buffer that is capped at 100 strings, so
-// pointers returned from this become invalid after 99 more
-// calls. Only use this to give cstr args to C routines in
-// the same scope. Keep this far away from any recursion.
-const char *cstr(const QString &qstr);
+// UTF-8 version of a string, for passing string args to C
+// routines. Converted string is owned by this object, so
+// pointer returned by get() is valid for as long as
+// object is alive. A temporary CStr is enough for an arg
+// of a single call, for anything longer than that create
+// a named CStr. Strings that take up to 255 bytes in UTF-8
+// are stored on the stack, so conversion doesn't allocate.
+// Longer strings go to the heap. Safe to use from multiple
+// threads since there's no shared state.
+class CStr {
+public:
+    explicit CStr(const QString &string);
+
+    const char *get() const;
+    int size() const;
+
+    operator const char *() const {
+        return get();
+    }
+
+    // NOTE: for C API's that take non-const char * but
+    // don't modify the string
+    char *data();
+
+private:
+    QVarLengthArray<char, 256> buffer;
+};
 
 // NOTE: you must call Q_INIT_RESOURCE(adldap) before
 // calling this
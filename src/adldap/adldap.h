@@ -21,6 +21,7 @@
 #ifndef ADLDAP_H
 #define ADLDAP_H
 
+#include "ad_atom.h"
 #include "ad_config.h"
 #include "ad_defines.h"
 #include "ad_display.h"
@@ -73,6 +73,13 @@ bool AttributeEdit::apply(AdInterface &ad, const QString &dn) const {
     return true;
 }
 
+bool AttributeEdit::apply_to_batch(AdModifyBatch *batch, const QString &dn) const {
+    UNUSED_ARG(batch);
+    UNUSED_ARG(dn);
+
+    return false;
+}
+
 void AttributeEdit::set_enabled(const bool enabled) {
     UNUSED_ARG(enabled);
 }
@@ -31,6 +31,7 @@
  */
 
 class AdInterface;
+class AdModifyBatch;
 class AdObject;
 
 class AttributeEdit : public QObject {
@@ -68,6 +69,13 @@ public:
     // AD server
     virtual bool apply(AdInterface &ad, const QString &dn) const;
 
+    // Add modifications of this edit to batch instead of
+    // applying them right away. Used when applying the
+    // same edit to many objects. Returns false if edit
+    // doesn't support batches, in which case nothing is
+    // added and apply() should be used instead.
+    virtual bool apply_to_batch(AdModifyBatch *batch, const QString &dn) const;
+
     virtual void set_enabled(const bool enabled);
 
 signals:
@@ -212,7 +212,9 @@ void country_combo_load(QComboBox *combo, const AdObject &object) {
     }
 }
 
-bool country_combo_apply(const QComboBox *combo, AdInterface &ad, const QString &dn) {
+// Returns list of attribute/value pairs for the country
+// that is selected in combo, in order of applying
+static QList<QPair<QString, QString>> country_combo_get_values(const QComboBox *combo) {
     const int code = combo->currentData().toInt();
 
     // NOTE: this handles the COUNTRY_CODE_NONE case by
@@ -221,10 +223,28 @@ bool country_combo_apply(const QComboBox *combo, AdInterface &ad, const QString
     const QString country_string = country_strings.value(code, QString());
     const QString abbreviation = country_abbreviations.value(code, QString());
 
+    return {
+        {ATTRIBUTE_COUNTRY_CODE, code_string},
+        {ATTRIBUTE_COUNTRY_ABBREVIATION, abbreviation},
+        {ATTRIBUTE_COUNTRY, country_string},
+    };
+}
+
+bool country_combo_apply(const QComboBox *combo, AdInterface &ad, const QString &dn) {
+    const QList<QPair<QString, QString>> value_list = country_combo_get_values(combo);
+
     bool success = true;
-    success = success && ad.attribute_replace_string(dn, ATTRIBUTE_COUNTRY_CODE, code_string);
-    success = success && ad.attribute_replace_string(dn, ATTRIBUTE_COUNTRY_ABBREVIATION, abbreviation);
-    success = success && ad.attribute_replace_string(dn, ATTRIBUTE_COUNTRY, country_string);
+    for (const QPair<QString, QString> &pair : value_list) {
+        success = success && ad.attribute_replace_string(dn, pair.first, pair.second);
+    }
 
     return success;
 }
+
+void country_combo_apply_to_batch(const QComboBox *combo, AdModifyBatch *batch, const QString &dn) {
+    const QList<QPair<QString, QString>> value_list = country_combo_get_values(combo);
+
+    for (const QPair<QString, QString> &pair : value_list) {
+        batch->replace_string(dn, pair.first, pair.second);
+    }
+}
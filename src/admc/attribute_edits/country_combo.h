@@ -24,11 +24,13 @@
 class QComboBox;
 class AdObject;
 class AdInterface;
+class AdModifyBatch;
 class QString;
 
 void country_combo_load_data();
 void country_combo_init(QComboBox *combo);
 void country_combo_load(QComboBox *combo, const AdObject &object);
 bool country_combo_apply(const QComboBox *combo, AdInterface &ad, const QString &dn);
+void country_combo_apply_to_batch(const QComboBox *combo, AdModifyBatch *batch, const QString &dn);
 
 #endif /* COUNTRY_COMBO_H */
@@ -48,6 +48,12 @@ bool CountryEdit::apply(AdInterface &ad, const QString &dn) const {
     return country_combo_apply(combo, ad, dn);
 }
 
+bool CountryEdit::apply_to_batch(AdModifyBatch *batch, const QString &dn) const {
+    country_combo_apply_to_batch(combo, batch, dn);
+
+    return true;
+}
+
 void CountryEdit::set_enabled(const bool enabled) {
     combo->setEnabled(enabled);
 }
@@ -44,6 +44,12 @@ bool ExpiryEdit::apply(AdInterface &ad, const QString &dn) const {
     return edit_widget->apply(ad, dn);
 }
 
+bool ExpiryEdit::apply_to_batch(AdModifyBatch *batch, const QString &dn) const {
+    edit_widget->apply_to_batch(batch, dn);
+
+    return true;
+}
+
 void ExpiryEdit::set_enabled(const bool enabled) {
     edit_widget->setEnabled(enabled);
 }
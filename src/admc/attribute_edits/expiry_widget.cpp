@@ -84,14 +84,26 @@ void ExpiryWidget::load(const AdObject &object) {
 }
 
 bool ExpiryWidget::apply(AdInterface &ad, const QString &dn) const {
+    const QString value = get_new_value();
+
+    return ad.attribute_replace_string(dn, ATTRIBUTE_ACCOUNT_EXPIRES, value);
+}
+
+void ExpiryWidget::apply_to_batch(AdModifyBatch *batch, const QString &dn) const {
+    const QString value = get_new_value();
+
+    batch->replace_string(dn, ATTRIBUTE_ACCOUNT_EXPIRES, value);
+}
+
+QString ExpiryWidget::get_new_value() const {
     const bool never = ui->never_check->isChecked();
 
     if (never) {
-        return ad.attribute_replace_string(dn, ATTRIBUTE_ACCOUNT_EXPIRES, AD_LARGE_INTEGER_DATETIME_NEVER_2);
+        return QString(AD_LARGE_INTEGER_DATETIME_NEVER_2);
     } else {
         const QDateTime datetime = QDateTime(ui->date_edit->date(), END_OF_DAY, Qt::UTC);
 
-        return ad.attribute_replace_datetime(dn, ATTRIBUTE_ACCOUNT_EXPIRES, datetime);
+        return datetime_qdatetime_to_string(ATTRIBUTE_ACCOUNT_EXPIRES, datetime, g_adconfig);
     }
 }
 
@@ -24,6 +24,7 @@
 #include <QWidget>
 
 class AdInterface;
+class AdModifyBatch;
 class AdObject;
 
 namespace Ui {
@@ -40,6 +41,7 @@ public:
 
     void load(const AdObject &object);
     bool apply(AdInterface &ad, const QString &dn) const;
+    void apply_to_batch(AdModifyBatch *batch, const QString &dn) const;
 
 signals:
     void edited();
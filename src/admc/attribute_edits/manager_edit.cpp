@@ -47,6 +47,12 @@ bool ManagerEdit::apply(AdInterface &ad, const QString &dn) const {
     return widget->apply(ad, dn);
 }
 
+bool ManagerEdit::apply_to_batch(AdModifyBatch *batch, const QString &dn) const {
+    widget->apply_to_batch(batch, dn);
+
+    return true;
+}
+
 void ManagerEdit::set_enabled(const bool enabled) {
     widget->setEnabled(enabled);
 }
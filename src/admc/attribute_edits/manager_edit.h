@@ -40,6 +40,7 @@ public:
 
     void load(AdInterface &ad, const AdObject &object) override;
     bool apply(AdInterface &ad, const QString &dn) const override;
+    bool apply_to_batch(AdModifyBatch *batch, const QString &dn) const override;
     void set_enabled(const bool enabled) override;
 
     QString get_manager() const;
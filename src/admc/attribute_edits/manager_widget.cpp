@@ -65,6 +65,10 @@ bool ManagerWidget::apply(AdInterface &ad, const QString &dn) const {
     return success;
 }
 
+void ManagerWidget::apply_to_batch(AdModifyBatch *batch, const QString &dn) const {
+    batch->replace_string(dn, manager_attribute, current_value);
+}
+
 QString ManagerWidget::get_manager() const {
     return current_value;
 }
@@ -25,6 +25,7 @@
 
 class AdObject;
 class AdInterface;
+class AdModifyBatch;
 
 namespace Ui {
 class ManagerWidget;
@@ -42,6 +43,7 @@ public:
     void set_attribute(const QString &attribute);
     void load(const AdObject &object);
     bool apply(AdInterface &ad, const QString &dn) const;
+    void apply_to_batch(AdModifyBatch *batch, const QString &dn) const;
 
     QString get_manager() const;
     void reset();
@@ -50,12 +50,23 @@ void StringEdit::load(AdInterface &ad, const AdObject &object) {
 }
 
 bool StringEdit::apply(AdInterface &ad, const QString &dn) const {
-    const QString new_value = edit->text().trimmed();
+    const QString new_value = get_new_value();
     const bool success = ad.attribute_replace_string(dn, attribute, new_value);
 
     return success;
 }
 
+bool StringEdit::apply_to_batch(AdModifyBatch *batch, const QString &dn) const {
+    const QString new_value = get_new_value();
+    batch->replace_string(dn, attribute, new_value);
+
+    return true;
+}
+
 void StringEdit::set_enabled(const bool enabled) {
     edit->setEnabled(enabled);
 }
+
+QString StringEdit::get_new_value() const {
+    return edit->text().trimmed();
+}
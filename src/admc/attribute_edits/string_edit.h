@@ -32,12 +32,15 @@ public:
 
     void load(AdInterface &ad, const AdObject &object) override;
     bool apply(AdInterface &ad, const QString &dn) const override;
+    bool apply_to_batch(AdModifyBatch *batch, const QString &dn) const override;
     void set_enabled(const bool enabled) override;
 
 private:
     QLineEdit *edit;
     QString attribute;
 
+    QString get_new_value() const;
+
     friend class StringOtherEdit;
 };
 
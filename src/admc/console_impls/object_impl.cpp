@@ -38,6 +38,7 @@
 #include "create_user_dialog.h"
 #include "find_object_dialog.h"
 #include "globals.h"
+#include "object_row_data.h"
 #include "password_dialog.h"
 #include "properties_dialog.h"
 #include "properties_multi_dialog.h"
@@ -71,6 +72,9 @@ QString get_selected_target_dn_object(ConsoleWidget *console);
 void console_object_delete_dn_list(ConsoleWidget *console, const QList<QString> &dn_list, const QModelIndex &tree_root, const int type, const int dn_role);
 bool can_create_class_at_parent(const QString &create_class, const QString &parent_class);
 void console_object_move_and_rename(const QList<ConsoleWidget *> &console_list, AdInterface &ad, const QHash<QString, QString> &old_to_new_dn_map_arg, const QString &new_parent_dn);
+void console_object_search_internal(ConsoleWidget *console, const QModelIndex &index, const QString &base, const SearchScope scope, const QString &filter, const QList<QString> &attributes, const bool fetch_on_demand, const int vlv_offset);
+void console_object_search_state_set(QStandardItem *item);
+void console_object_search_state_restore(QStandardItem *item);
 
 ObjectImpl::ObjectImpl(ConsoleWidget *console_arg)
 : ConsoleImpl(console_arg) {
@@ -187,21 +191,7 @@ void ObjectImpl::fetch(const QModelIndex &index) {
     //
     // Search object's children
     //
-    const QString filter = [=]() {
-        QString out;
-
-        // NOTE: OR user filter with containers filter so
-        // that container objects are always shown, even if
-        // they are filtered out by user filter
-        if (object_filter_enabled) {
-            out = filter_OR({is_container_filter(), out});
-            out = filter_OR({object_filter, out});
-        }
-
-        out = advanced_features_filter(out);
-
-        return out;
-    }();
+    const QString filter = get_children_filter();
 
     const QList<QString> attributes = console_object_search_attributes();
 
@@ -218,7 +208,54 @@ void ObjectImpl::fetch(const QModelIndex &index) {
         }
     }
 
-    console_object_search(console, index, base, scope, filter, attributes);
+    // NOTE: non-container children are loaded in windows
+    // as results are scrolled, see fetch_more()
+    console_object_search_internal(console, index, base, scope, filter, attributes, true, 0);
+}
+
+// Loads next window of children in a new search, starting
+// from where previous search stopped
+void ObjectImpl::fetch_more(const QModelIndex &index) {
+    const bool is_fetching = index.data(ObjectRole_Fetching).toBool();
+    if (is_fetching) {
+        return;
+    }
+
+    const int resume_offset = index.data(ObjectRole_VlvResumeOffset).toInt();
+    if (resume_offset == 0) {
+        return;
+    }
+
+    const QString base = index.data(ObjectRole_DN).toString();
+    const QString filter = get_children_filter();
+    const QList<QString> attributes = console_object_search_attributes();
+
+    console_object_search_internal(console, index, base, SearchScope_Children, filter, attributes, true, resume_offset);
+}
+
+bool ObjectImpl::can_fetch_more(const QModelIndex &index) const {
+    const bool is_fetching = index.data(ObjectRole_Fetching).toBool();
+    const bool has_more = (index.data(ObjectRole_VlvResumeOffset).toInt() > 0);
+
+    const bool out = (is_fetching || has_more);
+
+    return out;
+}
+
+QString ObjectImpl::get_children_filter() const {
+    QString out;
+
+    // NOTE: OR user filter with containers filter so
+    // that container objects are always shown, even if
+    // they are filtered out by user filter
+    if (object_filter_enabled) {
+        out = filter_OR({is_container_filter(), out});
+        out = filter_OR({object_filter, out});
+    }
+
+    out = advanced_features_filter(out);
+
+    return out;
 }
 
 bool ObjectImpl::can_drop(const QList<QPersistentModelIndex> &dropped_list, const QSet<int> &dropped_type_list, const QPersistentModelIndex &target, const int target_type) {
@@ -677,23 +714,7 @@ void console_object_delete(const QList<ConsoleWidget *> &console_list, const QLi
 
     show_busy_indicator();
 
-    const QList<QString> deleted_list = [&]() {
-        QList<QString> out;
-
-        const QList<QString> target_list = index_list_to_dn_list(index_list, dn_role);
-
-        for (const QString &target : target_list) {
-            const bool success = ad.object_delete(target);
-
-            if (success) {
-                out.append(target);
-            }
-        }
-
-        return out;
-    }();
-
-    auto apply_changes = [&ad, &deleted_list](ConsoleWidget *target_console) {
+    auto apply_changes = [](ConsoleWidget *target_console, const QList<QString> &deleted_list) {
         const QList<QModelIndex> root_list = {
             get_object_tree_root(target_console),
             get_query_tree_root(target_console),
@@ -712,13 +733,69 @@ void console_object_delete(const QList<ConsoleWidget *> &console_list, const QLi
         }
     };
 
-    for (ConsoleWidget *console : console_list) {
-        apply_changes(console);
+    // NOTE: remove objects from consoles as soon as they
+    // are deleted, instead of waiting for all deletes to
+    // finish
+    auto on_result = [&](const QString &dn, const bool success) {
+        if (!success) {
+            return;
+        }
+
+        for (ConsoleWidget *console : console_list) {
+            apply_changes(console, {dn});
+        }
+    };
+
+    const QList<QString> target_list = index_list_to_dn_list(index_list, dn_role);
+    QList<QString> unknown_list;
+    ad.object_delete_list(target_list, on_result, OBJECT_DELETE_LIST_MAX, DoStatusMsg_Yes, &unknown_list);
+
+    // NOTE: for deletes with unknown outcome, check which
+    // objects are actually gone and remove those. Use a
+    // separate connection because the one used for
+    // deleting failed. Objects are removed only if server
+    // confirms that they don't exist. If check failed,
+    // objects are left in place.
+    QList<QString> still_unknown_list;
+
+    if (!unknown_list.isEmpty()) {
+        AdInterface check_ad;
+
+        const QHash<QString, bool> exists_map = [&]() {
+            if (check_ad.is_connected()) {
+                return check_ad.objects_exist(unknown_list);
+            } else {
+                return QHash<QString, bool>();
+            }
+        }();
+
+        for (const QString &dn : unknown_list) {
+            if (!exists_map.contains(dn)) {
+                still_unknown_list.append(dn);
+
+                continue;
+            }
+
+            const bool was_deleted = !exists_map[dn];
+
+            if (was_deleted) {
+                for (ConsoleWidget *console : console_list) {
+                    apply_changes(console, {dn});
+                }
+            }
+        }
     }
 
     hide_busy_indicator();
 
     g_status->display_ad_messages(ad, console_list[0]);
+
+    if (!still_unknown_list.isEmpty()) {
+        const QString title = QCoreApplication::translate("ObjectImpl", "Delete");
+        const QString text = QCoreApplication::translate("ObjectImpl", "Could not determine whether these objects were deleted. Refresh to see their current state:\n\n%1").arg(still_unknown_list.join("\n"));
+
+        message_box_warning(console_list[0], title, text);
+    }
 }
 
 void ObjectImpl::set_find_action_enabled(const bool enabled) {
@@ -1181,16 +1258,7 @@ void console_object_move_and_rename(const QList<ConsoleWidget *> &console_list,
 
     // NOTE: search for objects once here to reuse them
     // multiple times later
-    const QHash<QString, AdObject> object_map = [&]() {
-        QHash<QString, AdObject> out;
-
-        for (const QString &dn : new_dn_list) {
-            const AdObject object = ad.search_object(dn);
-            out[dn] = object;
-        }
-
-        return out;
-    }();
+    const QHash<QString, AdObject> object_map = ad.search_objects(new_dn_list, console_object_search_attributes());
 
     auto apply_changes = [&ad, &old_to_new_dn_map, &old_dn_list, &new_parent_dn, &object_map](ConsoleWidget *target_console) {
         // For object tree, we add items representing
@@ -1379,6 +1447,12 @@ void ObjectImpl::update_toolbar_actions() {
 }
 
 void object_impl_add_objects_to_console(ConsoleWidget *console, const QList<AdObject> &object_list, const QModelIndex &parent) {
+    const QList<ObjectRowData> row_data_list = object_row_data_make_list(object_list);
+
+    object_impl_add_row_data_to_console(console, row_data_list, parent);
+}
+
+void object_impl_add_row_data_to_console(ConsoleWidget *console, const QList<ObjectRowData> &row_data_list, const QModelIndex &parent) {
     if (!parent.isValid()) {
         return;
     }
@@ -1391,117 +1465,71 @@ void object_impl_add_objects_to_console(ConsoleWidget *console, const QList<AdOb
         return;
     }
 
-    for (const AdObject &object : object_list) {
-        if (object.is_empty())
-            continue;
-        const bool should_be_in_scope = [&]() {
-            // NOTE: "containers" referenced here don't mean
-            // objects with "container" object class.
-            // Instead it means all the objects that can
-            // have children(some of which are not
-            // "container" class).
-            const bool is_container = [=]() {
-                const QList<QString> filter_containers = g_adconfig->get_filter_containers();
-                const QString object_class = object.get_string(ATTRIBUTE_OBJECT_CLASS);
-
-                return filter_containers.contains(object_class);
-            }();
+    const bool show_non_containers_ON = settings_get_variant(SETTING_show_non_containers_in_console_tree).toBool();
 
-            const bool show_non_containers_ON = settings_get_variant(SETTING_show_non_containers_in_console_tree).toBool();
+    QList<QList<QStandardItem *>> row_list;
 
-            return (is_container || show_non_containers_ON);
-        }();
+    for (const ObjectRowData &row_data : row_data_list) {
+        const bool should_be_in_scope = (row_data.is_container || show_non_containers_ON);
 
-        const QList<QStandardItem *> row = [&]() {
-            if (should_be_in_scope) {
-                return console->add_scope_item(ItemType_Object, parent);
-            } else {
-                return console->add_results_item(ItemType_Object, parent);
-            }
-        }();
+        const QList<QStandardItem *> row = console->make_row(ItemType_Object, parent, should_be_in_scope);
+
+        console_object_load(row, row_data);
 
-        console_object_load(row, object);
+        row_list.append(row);
     }
+
+    console->add_rows(parent, row_list);
 }
 
 // Helper f-n that searches for objects and then adds them
 void object_impl_add_objects_to_console_from_dns(ConsoleWidget *console, AdInterface &ad, const QList<QString> &dn_list, const QModelIndex &parent) {
-    const QList<AdObject> object_list = [&]() {
-        QList<AdObject> out;
+    const QHash<QString, AdObject> object_map = ad.search_objects(dn_list, console_object_search_attributes());
 
-        for (const QString &dn : dn_list) {
-            const AdObject object = ad.search_object(dn);
-            out.append(object);
-        }
+    object_impl_add_objects_to_console(console, object_map.values(), parent);
+}
 
-        return out;
-    }();
+void console_object_load(const QList<QStandardItem *> row, const AdObject &object) {
+    const ObjectRowData row_data = object_row_data_make(object);
 
-    object_impl_add_objects_to_console(console, object_list, parent);
+    console_object_load(row, row_data);
 }
 
-void console_object_load(const QList<QStandardItem *> row, const AdObject &object) {
+void console_object_load(const QList<QStandardItem *> row, const ObjectRowData &row_data) {
     // Load attribute columns
-    for (int i = 0; i < g_adconfig->get_columns().count(); i++) {
-        const QString attribute = g_adconfig->get_columns()[i];
+    for (int i = 0; i < row_data.column_list.count() && i < row.count(); i++) {
+        const QString display_value = row_data.column_list[i];
 
-        if (!object.contains(attribute)) {
+        if (display_value.isNull()) {
             continue;
         }
 
-        const QString display_value = [attribute, object]() {
-            if (attribute == ATTRIBUTE_OBJECT_CLASS) {
-                const QString object_class = object.get_string(attribute);
-
-                if (object_class == CLASS_GROUP) {
-                    const GroupScope scope = object.get_group_scope();
-                    const QString scope_string = group_scope_string(scope);
-
-                    const GroupType type = object.get_group_type();
-                    const QString type_string = group_type_string_adjective(type);
-
-                    return QString("%1 - %2").arg(type_string, scope_string);
-                } else {
-                    return g_adconfig->get_class_display_name(object_class);
-                }
-            } else {
-                const QByteArray value = object.get_value(attribute);
-                return attribute_display_value(attribute, value, g_adconfig);
-            }
-        }();
-
         row[i]->setText(display_value);
     }
 
-    console_object_item_data_load(row[0], object);
-
-    const bool cannot_move = object.get_system_flag(SystemFlagsBit_CannotMove);
+    console_object_item_data_load(row[0], row_data);
 
     for (auto item : row) {
-        item->setDragEnabled(!cannot_move);
+        item->setDragEnabled(!row_data.cannot_move);
     }
 }
 
 void console_object_item_data_load(QStandardItem *item, const AdObject &object) {
-    const QIcon icon = get_object_icon(object);
-    item->setIcon(icon);
-
-    item->setData(object.get_dn(), ObjectRole_DN);
-
-    const QList<QString> object_classes = object.get_strings(ATTRIBUTE_OBJECT_CLASS);
-    item->setData(QVariant(object_classes), ObjectRole_ObjectClasses);
+    const ObjectRowData row_data = object_row_data_make(object);
 
-    const bool cannot_move = object.get_system_flag(SystemFlagsBit_CannotMove);
-    item->setData(cannot_move, ObjectRole_CannotMove);
-
-    const bool cannot_rename = object.get_system_flag(SystemFlagsBit_CannotRename);
-    item->setData(cannot_rename, ObjectRole_CannotRename);
+    console_object_item_data_load(item, row_data);
+}
 
-    const bool cannot_delete = object.get_system_flag(SystemFlagsBit_CannotDelete);
-    item->setData(cannot_delete, ObjectRole_CannotDelete);
+void console_object_item_data_load(QStandardItem *item, const ObjectRowData &row_data) {
+    const QIcon icon = get_object_icon(row_data.object_category);
+    item->setIcon(icon);
 
-    const bool account_disabled = object.get_account_option(AccountOption_Disabled, g_adconfig);
-    item->setData(account_disabled, ObjectRole_AccountDisabled);
+    item->setData(row_data.dn, ObjectRole_DN);
+    item->setData(QVariant(row_data.object_classes), ObjectRole_ObjectClasses);
+    item->setData(row_data.cannot_move, ObjectRole_CannotMove);
+    item->setData(row_data.cannot_rename, ObjectRole_CannotRename);
+    item->setData(row_data.cannot_delete, ObjectRole_CannotDelete);
+    item->setData(row_data.account_disabled, ObjectRole_AccountDisabled);
 }
 
 QList<QString> object_impl_column_labels() {
@@ -1552,6 +1580,15 @@ QList<QString> console_object_search_attributes() {
 // contains multiple workarounds for issues caused by that
 // case.
 void console_object_search(ConsoleWidget *console, const QModelIndex &index, const QString &base, const SearchScope scope, const QString &filter, const QList<QString> &attributes) {
+    console_object_search_internal(console, index, base, scope, filter, attributes, false, 0);
+}
+
+// If fetch_on_demand is true, then search loads one window
+// of children, starting at vlv_offset. Next window is
+// loaded by ObjectImpl::fetch_more(). Containers are
+// needed for the scope tree, so they are not split into
+// windows and are all loaded by the first search.
+void console_object_search_internal(ConsoleWidget *console, const QModelIndex &index, const QString &base, const SearchScope scope, const QString &filter, const QList<QString> &attributes, const bool fetch_on_demand, const int vlv_offset) {
     auto search_id_matches = [](QStandardItem *item, SearchThread *thread) {
         const int id_from_item = item->data(MyConsoleRole_SearchThreadId).toInt();
         const int thread_id = thread->get_id();
@@ -1563,27 +1600,16 @@ void console_object_search(ConsoleWidget *console, const QModelIndex &index, con
 
     QStandardItem *item = console->get_item(index);
 
-    // Save original icon
-
-    // NOTE: only save original icon if there isn't one
-    // saved already. If this search overlaps a previous
-    // one, then previous search would've already saved it.
-    const QString icon_before_search_current = item->data(MyConsoleRole_IconBeforeSearch).toString();
-    if (icon_before_search_current.isEmpty()) {
-        const QIcon original_icon = item->icon();
-        const QString original_icon_name = original_icon.name();
-        item->setData(original_icon_name, MyConsoleRole_IconBeforeSearch);
-    }
-
-    // Set icon to indicate that item is in "search" state
-    item->setIcon(QIcon::fromTheme("system-search"));
-
-    // NOTE: need to set this role to disable actions during
-    // fetch
-    item->setData(true, ObjectRole_Fetching);
-    item->setDragEnabled(false);
+    console_object_search_state_set(item);
+    item->setData(0, ObjectRole_VlvResumeOffset);
 
     auto search_thread = new SearchThread(base, scope, filter, attributes);
+    search_thread->set_fetch_on_demand(fetch_on_demand);
+    search_thread->set_vlv_offset(vlv_offset);
+
+    if (fetch_on_demand) {
+        search_thread->set_load_all_filter(is_container_filter());
+    }
 
     // NOTE: change item's search thread, this will be used
     // later to handle situations where a thread is started
@@ -1597,10 +1623,14 @@ void console_object_search(ConsoleWidget *console, const QModelIndex &index, con
     // This is to be able to define queuedconnection type,
     // because there's no connect() version with no receiver
     // which has a connection type argument.
+    // NOTE: let thread prepare row data, so that only
+    // item creation is done in GUI thread
+    search_thread->set_make_row_data(true);
+
     QObject::connect(
-        search_thread, &SearchThread::results_ready,
+        search_thread, &SearchThread::row_data_ready,
         console,
-        [=](const QHash<QString, AdObject> &results) {
+        [=](const QList<ObjectRowData> &row_data_list) {
             // NOTE: fetched index might become invalid for
             // many reasons, parent getting moved, deleted,
             // item at the index itself might get modified.
@@ -1625,13 +1655,17 @@ void console_object_search(ConsoleWidget *console, const QModelIndex &index, con
                 return;
             }
 
-            object_impl_add_objects_to_console(console, results.values(), persistent_index);
+            object_impl_add_row_data_to_console(console, row_data_list, persistent_index);
         },
         Qt::QueuedConnection);
     QObject::connect(
         search_thread, &SearchThread::finished,
         console,
         [=]() {
+            // NOTE: deletion is deferred, so thread can
+            // still be used below
+            search_thread->deleteLater();
+
             if (!persistent_index.isValid()) {
                 return;
             }
@@ -1649,21 +1683,53 @@ void console_object_search(ConsoleWidget *console, const QModelIndex &index, con
                 return;
             }
 
-            const QString original_icon_name = item_now->data(MyConsoleRole_IconBeforeSearch).toString();
-            item_now->setIcon(QIcon::fromTheme(original_icon_name));
-
-            // NOTE: empty IconBeforeSearch so next search
-            // can use this as clean state
-            item_now->setData(QString(), MyConsoleRole_IconBeforeSearch);
+            console_object_search_state_restore(item_now);
 
-            item_now->setData(false, ObjectRole_Fetching);
-            item_now->setDragEnabled(true);
+            item_now->setData(search_thread->get_vlv_resume_offset(), ObjectRole_VlvResumeOffset);
 
-            search_thread->deleteLater();
+            console->update_results_fetch_state(persistent_index);
         },
         Qt::QueuedConnection);
 
     search_thread->start();
+
+    console->update_results_fetch_state(index);
+}
+
+// Puts item into "search" state, in which it has a search
+// icon and actions on it are disabled
+void console_object_search_state_set(QStandardItem *item) {
+    // Save original icon
+
+    // NOTE: only save original icon if there isn't one
+    // saved already. If this search overlaps a previous
+    // one, then previous search would've already saved it.
+    const QString icon_before_search_current = item->data(MyConsoleRole_IconBeforeSearch).toString();
+    if (icon_before_search_current.isEmpty()) {
+        const QIcon original_icon = item->icon();
+        const QString original_icon_name = original_icon.name();
+        item->setData(original_icon_name, MyConsoleRole_IconBeforeSearch);
+    }
+
+    // Set icon to indicate that item is in "search" state
+    item->setIcon(get_theme_icon("system-search"));
+
+    // NOTE: need to set this role to disable actions during
+    // fetch
+    item->setData(true, ObjectRole_Fetching);
+    item->setDragEnabled(false);
+}
+
+void console_object_search_state_restore(QStandardItem *item) {
+    const QString original_icon_name = item->data(MyConsoleRole_IconBeforeSearch).toString();
+    item->setIcon(get_theme_icon(original_icon_name));
+
+    // NOTE: empty IconBeforeSearch so next search
+    // can use this as clean state
+    item->setData(QString(), MyConsoleRole_IconBeforeSearch);
+
+    item->setData(false, ObjectRole_Fetching);
+    item->setDragEnabled(true);
 }
 
 void console_object_tree_init(ConsoleWidget *console, AdInterface &ad) {
@@ -40,6 +40,7 @@ template <typename T>
 class QList;
 class ConsoleWidget;
 class ConsoleFilterDialog;
+class ObjectRowData;
 
 enum ObjectRole {
     ObjectRole_DN = MyConsoleRole_LAST + 1,
@@ -51,6 +52,10 @@ enum ObjectRole {
     ObjectRole_Fetching,
     ObjectRole_SearchId,
 
+    // Position of next window of children to load on
+    // demand, 0 if all children were loaded
+    ObjectRole_VlvResumeOffset,
+
     ObjectRole_LAST,
 };
 
@@ -68,6 +73,8 @@ public:
     void set_buddy_console(ConsoleWidget *buddy_console);
 
     void fetch(const QModelIndex &index) override;
+    void fetch_more(const QModelIndex &index) override;
+    bool can_fetch_more(const QModelIndex &index) const override;
     bool can_drop(const QList<QPersistentModelIndex> &dropped_list, const QSet<int> &dropped_type_list, const QPersistentModelIndex &target, const int target_type) override;
     void drop(const QList<QPersistentModelIndex> &dropped_list, const QSet<int> &dropped_type_list, const QPersistentModelIndex &target, const int target_type) override;
     QString get_description(const QModelIndex &index) const override;
@@ -141,12 +148,16 @@ private:
     void move_and_rename(AdInterface &ad, const QHash<QString, QString> &old_dn_list, const QString &new_parent_dn);
     void move(AdInterface &ad, const QList<QString> &old_dn_list, const QString &new_parent_dn);
     void update_toolbar_actions();
+    QString get_children_filter() const;
 };
 
 void object_impl_add_objects_to_console(ConsoleWidget *console, const QList<AdObject> &object_list, const QModelIndex &parent);
+void object_impl_add_row_data_to_console(ConsoleWidget *console, const QList<ObjectRowData> &row_data_list, const QModelIndex &parent);
 void object_impl_add_objects_to_console_from_dns(ConsoleWidget *console, AdInterface &ad, const QList<QString> &dn_list, const QModelIndex &parent);
 void console_object_load(const QList<QStandardItem *> row, const AdObject &object);
+void console_object_load(const QList<QStandardItem *> row, const ObjectRowData &row_data);
 void console_object_item_data_load(QStandardItem *item, const AdObject &object);
+void console_object_item_data_load(QStandardItem *item, const ObjectRowData &row_data);
 QList<QString> object_impl_column_labels();
 QList<int> object_impl_default_columns();
 QList<QString> console_object_search_attributes();
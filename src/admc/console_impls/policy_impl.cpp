@@ -28,6 +28,7 @@
 #include "console_impls/policy_ou_impl.h"
 #include "console_impls/policy_root_impl.h"
 #include "globals.h"
+#include "policy_perms_scan_thread.h"
 #include "policy_results_widget.h"
 #include "properties_dialog.h"
 #include "rename_policy_dialog.h"
@@ -88,19 +89,14 @@ void PolicyImpl::drop(const QList<QPersistentModelIndex> &dropped_list, const QS
 }
 
 void PolicyImpl::selected_as_scope(const QModelIndex &index) {
-    AdInterface ad;
-    if (ad_failed(ad, console)) {
-        return;
-    }
-
-    // When selecting a policy, check it's permissions to
-    // make sure that they permissions of GPT and GPC match.
-    // If they don't, offer to update GPT permissions.
+    // When selecting a policy, check whether background
+    // scan found that permissions of GPT and GPC don't
+    // match. If they don't, offer to update GPT
+    // permissions.
     const QString selected_gpo = index.data(PolicyRole_DN).toString();
-    bool ok = true;
-    const bool perms_ok = ad.gpo_check_perms(selected_gpo, &ok);
+    const bool perms_mismatch = policy_perms_mismatch(selected_gpo);
 
-    if (!perms_ok && ok) {
+    if (perms_mismatch) {
         const QString title = tr("Incorrect permissions detected");
         const QString text = tr("Permissions for this policy's GPT don't match the permissions for it's GPC object. Would you like to update GPT permissions?");
 
@@ -120,13 +116,23 @@ void PolicyImpl::selected_as_scope(const QModelIndex &index) {
                     return;
                 }
 
-                ad_inner.gpo_sync_perms(selected_gpo);
+                // NOTE: clearing scan result also updates
+                // badges, see PolicyPermsScanNotifier
+                auto on_sync_success = [selected_gpo]() {
+                    policy_perms_scan_clear(selected_gpo);
+                };
+
+                const bool sync_success = gpo_sync_perms_with_progress(ad_inner, selected_gpo, console, on_sync_success);
+
+                if (sync_success) {
+                    on_sync_success();
+                }
 
                 g_status->display_ad_messages(ad_inner, console);
             });
-    }
 
-    g_status->log_messages(ad);
+        sync_warning_dialog->open();
+    }
 
     policy_results->update(selected_gpo);
 }
@@ -260,17 +266,28 @@ void update_ou_item_gpo_lists_data(const QString &policy_dn, QStandardItem *poli
 
 }
 
+// Policies with mismatched permissions get a warning badge
+static const QIcon &policy_item_icon(QStandardItem *policy_item, ItemIconType icon_type) {
+    const QString dn = policy_item->data(PolicyRole_DN).toString();
+
+    if (policy_perms_mismatch(dn)) {
+        return get_console_tree_item_warning_icon(icon_type);
+    } else {
+        return get_console_tree_item_icon(icon_type);
+    }
+}
+
 void set_policy_icon(QStandardItem *policy_item, bool is_enforced, bool is_disabled) {
     if (is_enforced) {
         if (!is_disabled)
-            policy_item->setIcon(get_console_tree_item_icon(ItemIconType_Policy_Enforced));
+            policy_item->setIcon(policy_item_icon(policy_item, ItemIconType_Policy_Enforced));
         else
-            policy_item->setIcon(get_console_tree_item_icon(ItemIconType_Policy_Enforced_Disabled));
+            policy_item->setIcon(policy_item_icon(policy_item, ItemIconType_Policy_Enforced_Disabled));
     } else {
         if (!is_disabled)
-            policy_item->setIcon(get_console_tree_item_icon(ItemIconType_Policy_Link));
+            policy_item->setIcon(policy_item_icon(policy_item, ItemIconType_Policy_Link));
         else
-            policy_item->setIcon(get_console_tree_item_icon(ItemIconType_Policy_Link_Disabled));
+            policy_item->setIcon(policy_item_icon(policy_item, ItemIconType_Policy_Link_Disabled));
     }
 }
 
@@ -295,6 +312,13 @@ void console_policy_load(const QList<QStandardItem *> &row, const AdObject &obje
 void console_policy_load_item(QStandardItem *main_item, const AdObject &object) {
     main_item->setData(object.get_dn(), PolicyRole_DN);
 
+    console_policy_update_icon(main_item);
+
+    const QString display_name = object.get_string(ATTRIBUTE_DISPLAY_NAME);
+    main_item->setText(display_name);
+}
+
+void console_policy_update_icon(QStandardItem *main_item) {
     if (main_item->parent() != nullptr &&
             main_item->parent()->data(ConsoleRole_Type).toInt() == ItemType_PolicyOU) {
         bool is_enforced = policy_is_enforced(main_item);
@@ -302,11 +326,24 @@ void console_policy_load_item(QStandardItem *main_item, const AdObject &object)
 
         set_policy_icon(main_item, is_enforced, is_disabled);
     } else {
-        main_item->setIcon(get_object_icon(object));
+        main_item->setIcon(policy_item_icon(main_item, ItemIconType_Policy_Clean));
     }
+}
 
-    const QString display_name = object.get_string(ATTRIBUTE_DISPLAY_NAME);
-    main_item->setText(display_name);
+void console_policy_update_perms_badges(ConsoleWidget *console, const QList<QString> &dn_list) {
+    const QModelIndex policy_root = get_policy_tree_root(console);
+    if (!policy_root.isValid()) {
+        return;
+    }
+
+    for (const QString &dn : dn_list) {
+        const QList<QModelIndex> policy_index_list = console->search_items(policy_root, PolicyRole_DN, dn, {ItemType_Policy});
+
+        for (const QModelIndex &policy_index : policy_index_list) {
+            QStandardItem *policy_item = console->get_item(policy_index);
+            console_policy_update_icon(policy_item);
+        }
+    }
 }
 
 void console_policy_edit(ConsoleWidget *console, const int item_type, const int dn_role) {
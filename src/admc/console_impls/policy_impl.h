@@ -83,6 +83,8 @@ private:
 
 void console_policy_load(const QList<QStandardItem *> &row, const AdObject &object);
 void console_policy_load_item(QStandardItem *item, const AdObject &object);
+void console_policy_update_icon(QStandardItem *item);
+void console_policy_update_perms_badges(ConsoleWidget *console, const QList<QString> &dn_list);
 QList<QString> console_policy_search_attributes();
 void console_policy_edit(ConsoleWidget *console, const int item_type, const int dn_role);
 void console_policy_rename(const QList<ConsoleWidget *> &console_list, PolicyResultsWidget *policy_results, const int item_type, const int dn_role);
@@ -326,18 +326,9 @@ void PolicyOUImpl::delete_action(const QList<QModelIndex> &index_list) {
 }
 
 void policy_ou_impl_add_objects_from_dns(ConsoleWidget *console, AdInterface &ad, const QList<QString> &dn_list, const QModelIndex &parent) {
-    const QList<AdObject> object_list = [&]() {
-        QList<AdObject> out;
+    const QHash<QString, AdObject> object_map = ad.search_objects(dn_list, console_object_search_attributes());
 
-        for (const QString &dn : dn_list) {
-            const AdObject object = ad.search_object(dn);
-            out.append(object);
-        }
-
-        return out;
-    }();
-
-    policy_ou_impl_add_objects_to_console(console, object_list, parent);
+    policy_ou_impl_add_objects_to_console(console, object_map.values(), parent);
 }
 
 void policy_ou_impl_add_objects_to_console(ConsoleWidget *console, const QList<AdObject> &object_list, const QModelIndex &parent) {
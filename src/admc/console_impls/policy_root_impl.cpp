@@ -23,10 +23,12 @@
 #include "adldap.h"
 #include "console_impls/all_policies_folder_impl.h"
 #include "console_impls/item_type.h"
+#include "console_impls/policy_impl.h"
 #include "console_impls/policy_ou_impl.h"
 #include "console_widget/results_view.h"
 #include "globals.h"
 #include "gplink.h"
+#include "policy_perms_scan_thread.h"
 #include "status.h"
 #include "utils.h"
 
@@ -36,6 +38,15 @@
 PolicyRootImpl::PolicyRootImpl(ConsoleWidget *console_arg)
 : ConsoleImpl(console_arg) {
     set_results_view(new ResultsView(console_arg));
+
+    perms_scan_thread = nullptr;
+
+    connect(
+        policy_perms_scan_notifier(), &PolicyPermsScanNotifier::cleared,
+        this,
+        [this](const QString &dn) {
+            console_policy_update_perms_badges(console, {dn});
+        });
 }
 
 void PolicyRootImpl::fetch(const QModelIndex &index) {
@@ -54,6 +65,8 @@ void PolicyRootImpl::fetch(const QModelIndex &index) {
 
     const QString domain_name = g_adconfig->domain().toLower();
     domain_item->setText(domain_name);
+
+    start_perms_scan();
 }
 
 void PolicyRootImpl::refresh(const QList<QModelIndex> &index_list) {
@@ -82,6 +95,33 @@ QList<int> PolicyRootImpl::default_columns() const {
     return {0};
 }
 
+void PolicyRootImpl::start_perms_scan() {
+    // NOTE: don't start another scan while previous one is
+    // in progress, it would check the same policies
+    if (perms_scan_thread != nullptr) {
+        return;
+    }
+
+    perms_scan_thread = new PolicyPermsScanThread();
+
+    connect(
+        perms_scan_thread, &PolicyPermsScanThread::results_ready,
+        this,
+        [this](const QHash<QString, bool> &results) {
+            policy_perms_scan_load_results(results);
+            console_policy_update_perms_badges(console, results.keys());
+        });
+    connect(
+        perms_scan_thread, &PolicyPermsScanThread::finished,
+        this,
+        [this]() {
+            perms_scan_thread->deleteLater();
+            perms_scan_thread = nullptr;
+        });
+
+    perms_scan_thread->start();
+}
+
 void console_policy_tree_init(ConsoleWidget *console) {
     const QList<QStandardItem *> head_row = console->add_scope_item(ItemType_PolicyRoot, QModelIndex());
     auto policy_tree_head = head_row[0];
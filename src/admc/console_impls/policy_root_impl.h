@@ -23,12 +23,17 @@
 
 /**
  * Impl for the root of the policy tree which contains the
- * root of the domain and "All policies" folder.
+ * root of the domain and "All policies" folder. Fetching
+ * also starts a background check of permissions of all
+ * policies, policies with mismatched permissions are
+ * displayed with a warning badge.
  */
 
 #include "console_widget/console_impl.h"
 #include "console_widget/console_widget.h"
 
+class PolicyPermsScanThread;
+
 class PolicyRootImpl final : public ConsoleImpl {
     Q_OBJECT
 
@@ -42,6 +47,11 @@ public:
 
     QList<QString> column_labels() const override;
     QList<int> default_columns() const override;
+
+private:
+    PolicyPermsScanThread *perms_scan_thread;
+
+    void start_perms_scan();
 };
 
 void console_policy_tree_init(ConsoleWidget *console);
@@ -37,6 +37,16 @@ void ConsoleImpl::fetch(const QModelIndex &index) {
     UNUSED_ARG(index);
 }
 
+void ConsoleImpl::fetch_more(const QModelIndex &index) {
+    UNUSED_ARG(index);
+}
+
+bool ConsoleImpl::can_fetch_more(const QModelIndex &index) const {
+    UNUSED_ARG(index);
+
+    return false;
+}
+
 bool ConsoleImpl::can_drop(const QList<QPersistentModelIndex> &dropped_list, const QSet<int> &dropped_type_list, const QPersistentModelIndex &target, const int target_type) {
     UNUSED_ARG(dropped_list);
     UNUSED_ARG(dropped_type_list);
@@ -49,6 +49,18 @@ public:
     // static, you don't need to implement this.
     virtual void fetch(const QModelIndex &index);
 
+    // Called when results of a scope item of this type are
+    // scrolled to the end. Implement this if children are
+    // loaded in parts, to load the next part.
+    virtual void fetch_more(const QModelIndex &index);
+
+    // Return true if results of this item are only partly
+    // loaded, either because more are being loaded or
+    // because fetch_more() can load more. While this is
+    // true, results view is kept sorted by the first
+    // column, in which parts are expected to be loaded.
+    virtual bool can_fetch_more(const QModelIndex &index) const;
+
     // Called when items are dragged on top of an item of
     // this type to determine whether dropping is allowed.
     // Note that dragged items may be of any type and even
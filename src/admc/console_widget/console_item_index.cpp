@@ -0,0 +1,254 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "console_widget/console_item_index.h"
+
+#include <QStack>
+#include <QStandardItemModel>
+
+QString value_to_key(const QVariant &value);
+int normalize_role(const int role);
+
+ConsoleItemIndex::ConsoleItemIndex(QStandardItemModel *model_arg)
+: QObject(model_arg) {
+    model = model_arg;
+
+    connect(
+        model, &QAbstractItemModel::rowsInserted,
+        this, &ConsoleItemIndex::on_rows_inserted);
+    connect(
+        model, &QAbstractItemModel::rowsAboutToBeRemoved,
+        this, &ConsoleItemIndex::on_rows_about_to_be_removed);
+    connect(
+        model, &QAbstractItemModel::dataChanged,
+        this, &ConsoleItemIndex::on_data_changed);
+    connect(
+        model, &QAbstractItemModel::modelAboutToBeReset,
+        this, &ConsoleItemIndex::on_model_reset);
+}
+
+QList<QStandardItem *> ConsoleItemIndex::find(const int role_arg, const QVariant &value) {
+    const int role = normalize_role(role_arg);
+
+    if (!value_map.contains(role)) {
+        build(role);
+    }
+
+    const QSet<QStandardItem *> candidate_set = value_map[role].value(value_to_key(value));
+
+    // NOTE: keys are string representations of values, so
+    // different values may share a key. Compare actual
+    // values to get exact matches.
+    QList<QStandardItem *> out;
+    for (QStandardItem *item : candidate_set) {
+        if (item->data(role) == value) {
+            out.append(item);
+        }
+    }
+
+    return out;
+}
+
+void ConsoleItemIndex::build(const int role) {
+    value_map[role] = QHash<QString, QSet<QStandardItem *>>();
+    key_map[role] = QHash<QStandardItem *, QString>();
+
+    QStandardItem *root = model->invisibleRootItem();
+    for (int row = 0; row < root->rowCount(); row++) {
+        QStack<QStandardItem *> stack;
+        stack.push(root->child(row, 0));
+
+        while (!stack.isEmpty()) {
+            QStandardItem *item = stack.pop();
+            if (item == nullptr) {
+                continue;
+            }
+
+            add_item(item, role);
+
+            for (int child_row = 0; child_row < item->rowCount(); child_row++) {
+                stack.push(item->child(child_row, 0));
+            }
+        }
+    }
+}
+
+void ConsoleItemIndex::add_item(QStandardItem *item, const int role) {
+    const QVariant value = item->data(role);
+    if (!value.isValid()) {
+        return;
+    }
+
+    const QString key = value_to_key(value);
+
+    value_map[role][key].insert(item);
+    key_map[role][item] = key;
+}
+
+void ConsoleItemIndex::remove_item(QStandardItem *item, const int role) {
+    QHash<QStandardItem *, QString> &role_key_map = key_map[role];
+
+    if (!role_key_map.contains(item)) {
+        return;
+    }
+
+    const QString key = role_key_map.take(item);
+
+    QHash<QString, QSet<QStandardItem *>> &role_value_map = value_map[role];
+    QSet<QStandardItem *> &item_set = role_value_map[key];
+    item_set.remove(item);
+
+    if (item_set.isEmpty()) {
+        role_value_map.remove(key);
+    }
+}
+
+void ConsoleItemIndex::add_subtree(QStandardItem *subtree_root) {
+    const QList<int> role_list = value_map.keys();
+
+    QStack<QStandardItem *> stack;
+    stack.push(subtree_root);
+
+    while (!stack.isEmpty()) {
+        QStandardItem *item = stack.pop();
+        if (item == nullptr) {
+            continue;
+        }
+
+        for (const int role : role_list) {
+            add_item(item, role);
+        }
+
+        for (int row = 0; row < item->rowCount(); row++) {
+            stack.push(item->child(row, 0));
+        }
+    }
+}
+
+void ConsoleItemIndex::remove_subtree(QStandardItem *subtree_root) {
+    const QList<int> role_list = value_map.keys();
+
+    QStack<QStandardItem *> stack;
+    stack.push(subtree_root);
+
+    while (!stack.isEmpty()) {
+        QStandardItem *item = stack.pop();
+        if (item == nullptr) {
+            continue;
+        }
+
+        for (const int role : role_list) {
+            remove_item(item, role);
+        }
+
+        for (int row = 0; row < item->rowCount(); row++) {
+            stack.push(item->child(row, 0));
+        }
+    }
+}
+
+void ConsoleItemIndex::on_rows_inserted(const QModelIndex &parent, int first, int last) {
+    if (value_map.isEmpty()) {
+        return;
+    }
+
+    for (int row = first; row <= last; row++) {
+        const QModelIndex index = model->index(row, 0, parent);
+        QStandardItem *item = model->itemFromIndex(index);
+
+        add_subtree(item);
+    }
+}
+
+void ConsoleItemIndex::on_rows_about_to_be_removed(const QModelIndex &parent, int first, int last) {
+    if (value_map.isEmpty()) {
+        return;
+    }
+
+    for (int row = first; row <= last; row++) {
+        const QModelIndex index = model->index(row, 0, parent);
+        QStandardItem *item = model->itemFromIndex(index);
+
+        remove_subtree(item);
+    }
+}
+
+void ConsoleItemIndex::on_data_changed(const QModelIndex &top_left, const QModelIndex &bottom_right, const QVector<int> &roles) {
+    if (value_map.isEmpty()) {
+        return;
+    }
+
+    // NOTE: only first column is indexed
+    if (top_left.column() != 0) {
+        return;
+    }
+
+    // NOTE: empty roles list means that all roles may
+    // have changed
+    const QList<int> changed_role_list = [&]() {
+        if (roles.isEmpty()) {
+            return value_map.keys();
+        }
+
+        QList<int> out;
+
+        for (const int role : roles) {
+            const int normalized_role = normalize_role(role);
+
+            if (value_map.contains(normalized_role) && !out.contains(normalized_role)) {
+                out.append(normalized_role);
+            }
+        }
+
+        return out;
+    }();
+
+    for (int row = top_left.row(); row <= bottom_right.row(); row++) {
+        const QModelIndex index = model->index(row, 0, top_left.parent());
+        QStandardItem *item = model->itemFromIndex(index);
+        if (item == nullptr) {
+            continue;
+        }
+
+        for (const int role : changed_role_list) {
+            remove_item(item, role);
+            add_item(item, role);
+        }
+    }
+}
+
+void ConsoleItemIndex::on_model_reset() {
+    // NOTE: indexes will be rebuilt on next search
+    value_map.clear();
+    key_map.clear();
+}
+
+QString value_to_key(const QVariant &value) {
+    return value.toString();
+}
+
+// NOTE: standard items store edit role as display role
+int normalize_role(const int role) {
+    if (role == Qt::EditRole) {
+        return Qt::DisplayRole;
+    } else {
+        return role;
+    }
+}
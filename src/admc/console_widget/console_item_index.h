@@ -0,0 +1,76 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CONSOLE_ITEM_INDEX_H
+#define CONSOLE_ITEM_INDEX_H
+
+/**
+ * Index of console model items by role value. Used by
+ * console search f-ns so that finding an item doesn't
+ * require visiting every item in the model. Index for a
+ * role is built when that role is searched for the first
+ * time, after which it is updated incrementally as rows
+ * are inserted, removed and changed. Only items in the
+ * first column are indexed, same as for recursive
+ * QAbstractItemModel::match().
+ */
+
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QVariant>
+
+class QStandardItem;
+class QStandardItemModel;
+class QModelIndex;
+
+class ConsoleItemIndex final : public QObject {
+    Q_OBJECT
+
+public:
+    ConsoleItemIndex(QStandardItemModel *model_arg);
+
+    // Returns items for which item's data for given role
+    // is equal to value. Order of items is undefined.
+    QList<QStandardItem *> find(const int role, const QVariant &value);
+
+private:
+    QStandardItemModel *model;
+
+    // role => value key => items
+    QHash<int, QHash<QString, QSet<QStandardItem *>>> value_map;
+
+    // role => item => value key, needed to remove items
+    // from value map after their data changed
+    QHash<int, QHash<QStandardItem *, QString>> key_map;
+
+    void build(const int role);
+    void add_item(QStandardItem *item, const int role);
+    void remove_item(QStandardItem *item, const int role);
+    void add_subtree(QStandardItem *item);
+    void remove_subtree(QStandardItem *item);
+
+    void on_rows_inserted(const QModelIndex &parent, int first, int last);
+    void on_rows_about_to_be_removed(const QModelIndex &parent, int first, int last);
+    void on_data_changed(const QModelIndex &top_left, const QModelIndex &bottom_right, const QVector<int> &roles);
+    void on_model_reset();
+};
+
+#endif /* CONSOLE_ITEM_INDEX_H */
@@ -21,6 +21,7 @@ enum IconOverlayPosition {
 struct ConsoleTreeItemIcons final
 {
     QIcon icons_map[ItemIconType_LAST];
+    QIcon warning_icons_map[ItemIconType_LAST];
 
     ConsoleTreeItemIcons();
 };
@@ -45,6 +46,11 @@ ConsoleTreeItemIcons::ConsoleTreeItemIcons()
     icons_map[ItemIconType_Domain_InheritanceBlocked] = overlay_scope_item_icon(icons_map[ItemIconType_Domain_Clean],
                                                                                 QIcon::fromTheme("changes-prevent"),
                                                                                 QSize(10, 10), QPoint(6, 6));
+
+    const QIcon warning_icon = QIcon::fromTheme("dialog-warning");
+    for (int i = 0; i < ItemIconType_LAST; i++) {
+        warning_icons_map[i] = overlay_scope_item_icon(icons_map[i], warning_icon, IconOverlayPosition_TopLeft);
+    }
 }
 
 static QIcon overlay_scope_item_icon(const QIcon &clean_icon, const QIcon &overlay_icon, IconOverlayPosition position)
@@ -92,10 +98,21 @@ static QIcon overlay_scope_item_icon(const QIcon &clean_icon, const QIcon &overl
     return overlapped_icon;
 }
 
-const QIcon &get_console_tree_item_icon(ItemIconType icon_type)
+static const ConsoleTreeItemIcons &get_console_tree_item_icons()
 {
     static const ConsoleTreeItemIcons item_icons;
 
-    const QIcon &icon = item_icons.icons_map[icon_type];
+    return item_icons;
+}
+
+const QIcon &get_console_tree_item_icon(ItemIconType icon_type)
+{
+    const QIcon &icon = get_console_tree_item_icons().icons_map[icon_type];
+    return icon;
+}
+
+const QIcon &get_console_tree_item_warning_icon(ItemIconType icon_type)
+{
+    const QIcon &icon = get_console_tree_item_icons().warning_icons_map[icon_type];
     return icon;
 }
@@ -19,4 +19,8 @@ enum ItemIconType {
 
 const QIcon& get_console_tree_item_icon(ItemIconType icon_type);
 
+// Same icon with a warning badge, used for items with
+// problems that need user's attention
+const QIcon& get_console_tree_item_warning_icon(ItemIconType icon_type);
+
 #endif // CONSOLETREEITEMICONS_H
@@ -23,6 +23,7 @@
 
 #include "console_widget/console_drag_model.h"
 #include "console_widget/console_impl.h"
+#include "console_widget/console_item_index.h"
 #include "console_widget/customize_columns_dialog.h"
 #include "console_widget/results_view.h"
 #include "console_widget/scope_proxy_model.h"
@@ -106,6 +107,7 @@ ConsoleWidget::ConsoleWidget(QWidget *parent)
     d->scope_view->header()->setSectionResizeMode(QHeaderView::Interactive);
 
     d->model = new ConsoleDragModel(this);
+    d->item_index = new ConsoleItemIndex(d->model);
 
     // NOTE: using a proxy model for scope to be able to do
     // case insensitive sorting
@@ -248,21 +250,61 @@ void ConsoleWidget::register_impl(const int type, ConsoleImpl *impl) {
         connect(
             results_view, &ResultsView::selection_changed,
             this, &ConsoleWidget::selection_changed);
+        connect(
+            results_view, &ResultsView::scrolled_to_end,
+            d, &ConsoleWidgetPrivate::on_results_scrolled_to_end);
     }
 }
 
 QList<QStandardItem *> ConsoleWidget::add_scope_item(const int type, const QModelIndex &parent) {
-    const QList<QStandardItem *> row = add_results_item(type, parent);
-
-    row[0]->setData(false, ConsoleRole_WasFetched);
-    row[0]->setData(true, ConsoleRole_IsScope);
+    const QList<QStandardItem *> row = make_row(type, parent, true);
 
-    d->scope_proxy_model->sort(0, Qt::AscendingOrder);
+    add_rows(parent, {row});
 
     return row;
 }
 
 QList<QStandardItem *> ConsoleWidget::add_results_item(const int type, const QModelIndex &parent) {
+    const QList<QStandardItem *> row = make_row(type, parent, false);
+
+    add_rows(parent, {row});
+
+    return row;
+}
+
+QList<QStandardItem *> ConsoleWidget::make_row(const int type, const QModelIndex &parent, const bool is_scope) const {
+    const int column_count = [&]() {
+        if (parent.isValid()) {
+            ConsoleImpl *parent_impl = d->get_impl(parent);
+
+            return parent_impl->column_labels().size();
+        } else {
+            return 1;
+        }
+    }();
+
+    QList<QStandardItem *> row;
+
+    for (int i = 0; i < column_count; i++) {
+        const auto item = new QStandardItem();
+        row.append(item);
+    }
+
+    row[0]->setData(is_scope, ConsoleRole_IsScope);
+    row[0]->setData(type, ConsoleRole_Type);
+
+    if (is_scope) {
+        row[0]->setData(false, ConsoleRole_WasFetched);
+    }
+
+    return row;
+}
+
+void ConsoleWidget::add_rows(const QModelIndex &parent, const QList<QList<QStandardItem *>> &row_list) {
+    if (row_list.isEmpty()) {
+        return;
+    }
+
     QStandardItem *parent_item = [&]() {
         if (parent.isValid()) {
             return d->model->itemFromIndex(parent);
@@ -271,34 +313,29 @@ QList<QStandardItem *> ConsoleWidget::add_results_item(const int type, const QMo
         }
     }();
 
-    // Make item row
-    const QList<QStandardItem *> row = [&]() {
-        QList<QStandardItem *> out;
-
-        const int column_count = [&]() {
-            if (parent_item == d->model->invisibleRootItem()) {
-                return 1;
-            } else {
-                ConsoleImpl *parent_impl = d->get_impl(parent);
+    // NOTE: each row is appended with all of it's columns
+    // at once, so that model emits one insertion per row.
+    // Columns must never be attached to rows that are
+    // already in the model, because each attached item
+    // causes a layout change which makes proxy models
+    // rebuild their mappings.
+    for (const QList<QStandardItem *> &row : row_list) {
+        parent_item->appendRow(row);
+    }
 
-                return parent_impl->column_labels().size();
+    const bool added_scope_items = [&]() {
+        for (const QList<QStandardItem *> &row : row_list) {
+            if (row[0]->data(ConsoleRole_IsScope).toBool()) {
+                return true;
             }
-        }();
-
-        for (int i = 0; i < column_count; i++) {
-            const auto item = new QStandardItem();
-            out.append(item);
         }
 
-        return out;
+        return false;
     }();
 
-    row[0]->setData(false, ConsoleRole_IsScope);
-    row[0]->setData(type, ConsoleRole_Type);
-
-    parent_item->appendRow(row);
-
-    return row;
+    if (added_scope_items) {
+        d->scope_proxy_model->sort(0, Qt::AscendingOrder);
+    }
 }
 
 void ConsoleWidget::delete_item(const QModelIndex &index) {
@@ -330,6 +367,16 @@ void ConsoleWidget::refresh_scope(const QModelIndex &index) {
     impl->refresh({index});
 }
 
+void ConsoleWidget::update_results_fetch_state(const QModelIndex &index) {
+    const QModelIndex current_scope = get_current_scope_item();
+
+    if (index != current_scope) {
+        return;
+    }
+
+    d->update_results_fetch_state();
+}
+
 QList<QModelIndex> ConsoleWidget::get_selected_items(const int type) const {
     QList<QModelIndex> out;
 
@@ -356,75 +403,36 @@ QModelIndex ConsoleWidget::get_selected_item(const int type) const {
 }
 
 QList<QModelIndex> ConsoleWidget::search_items(const QModelIndex &parent, int role, const QVariant &value, const QList<int> &type_list) const {
-    const QList<QModelIndex> all_matches = [&]() {
-        QList<QModelIndex> out;
-
-        // NOTE: start index may be invalid if parent has no
-        // children
-        const QModelIndex start_index = d->model->index(0, 0, parent);
-        if (start_index.isValid()) {
-            const QList<QModelIndex> descendant_matches = d->model->match(start_index, role, value, -1, Qt::MatchFlags(Qt::MatchExactly | Qt::MatchRecursive));
-            out.append(descendant_matches);
-        }
-
-        const QVariant parent_value = parent.data(role);
-        const bool parent_is_match = (parent_value.isValid() && parent_value == value);
-        if (parent_is_match) {
-            out.append(parent);
-        }
+    QList<QModelIndex> out;
 
-        return out;
-    }();
+    const QList<QStandardItem *> all_matches = d->item_index->find(role, value);
 
-    const QList<QModelIndex> filtered_matches = [&]() {
-        if (type_list.isEmpty()) {
-            return all_matches;
+    for (QStandardItem *item : all_matches) {
+        if (!d->item_is_in_subtree(item, parent)) {
+            continue;
         }
 
-        QList<QModelIndex> out;
-
-        for (const QModelIndex &index : all_matches) {
-            const QVariant type_variant = index.data(ConsoleRole_Type);
-            if (type_variant.isValid()) {
-                const int this_type = type_variant.toInt();
+        if (!type_list.isEmpty()) {
+            const QVariant type_variant = item->data(ConsoleRole_Type);
+            const bool type_match = (type_variant.isValid() && type_list.contains(type_variant.toInt()));
 
-                if (type_list.contains(this_type)) {
-                    out.append(index);
-                }
+            if (!type_match) {
+                continue;
             }
         }
 
-        return out;
-    }();
+        out.append(item->index());
+    }
 
-    return filtered_matches;
+    return out;
 }
 
-// TODO: remove duplication between two search_items()
-// f-ns and deal with the weirdness around whether
-// search iteration includes parent or not. Once this
-// is done it may be possible to simplify
-// get_x_tree_root() f-ns.
 QList<QModelIndex> ConsoleWidget::search_items(const QModelIndex &parent, const QList<int> &type_list) const {
     QList<QModelIndex> out;
 
     for (const int type : type_list) {
-        const int role = ConsoleRole_Type;
-        const int value = type;
-
-        // NOTE: start index may be invalid if parent has no
-        // children
-        const QModelIndex start_index = d->model->index(0, 0, parent);
-        if (start_index.isValid()) {
-            const QList<QModelIndex> descendant_matches = d->model->match(start_index, role, value, -1, Qt::MatchFlags(Qt::MatchExactly | Qt::MatchRecursive));
-            out.append(descendant_matches);
-        }
-
-        const QVariant parent_value = parent.data(role);
-        const bool parent_is_match = (parent_value.isValid() && parent_value == value);
-        if (parent_is_match) {
-            out.append(parent);
-        }
+        const QList<QModelIndex> type_matches = search_items(parent, ConsoleRole_Type, type);
+        out.append(type_matches);
     }
 
     return out;
@@ -868,6 +876,34 @@ void ConsoleWidgetPrivate::set_results_to_type(const ResultsViewType type) {
         // is a separate selection for each type of
         // results view
         emit q->selection_changed();
+
+        update_results_fetch_state();
+    }
+}
+
+// Updates results view of current scope item depending on
+// whether it's results are partly loaded. If they are
+// and view is already at the end, for example because
+// loaded results fit without a scrollbar, then next part
+// is fetched right away, since view can't be scrolled.
+void ConsoleWidgetPrivate::update_results_fetch_state() {
+    const QModelIndex current_scope = q->get_current_scope_item();
+    if (!current_scope.isValid()) {
+        return;
+    }
+
+    ConsoleImpl *impl = get_impl(current_scope);
+    ResultsView *view = impl->view();
+    if (view == nullptr) {
+        return;
+    }
+
+    const bool can_fetch_more = impl->can_fetch_more(current_scope);
+
+    view->set_sorting_locked(can_fetch_more);
+
+    if (can_fetch_more && view->is_scrolled_to_end()) {
+        impl->fetch_more(current_scope);
     }
 }
 
@@ -912,6 +948,24 @@ void ConsoleWidgetPrivate::update_description() {
     description_bar_right->setText(description);
 }
 
+// NOTE: subtree is inclusive, so parent itself is also
+// in it. Invalid parent is the root of the whole model.
+bool ConsoleWidgetPrivate::item_is_in_subtree(QStandardItem *item, const QModelIndex &parent) const {
+    if (!parent.isValid()) {
+        return true;
+    }
+
+    QStandardItem *parent_item = model->itemFromIndex(parent);
+
+    for (QStandardItem *current = item; current != nullptr; current = current->parent()) {
+        if (current == parent_item) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 QList<QModelIndex> ConsoleWidgetPrivate::get_all_selected_items() const {
     ConsoleImpl *current_impl = get_current_scope_impl();
     ResultsView *results_view = current_impl->view();
@@ -1046,6 +1100,8 @@ void ConsoleWidgetPrivate::on_current_scope_item_changed(const QModelIndex &curr
     update_navigation_actions();
     update_view_actions();
 
+    update_results_fetch_state();
+
     fetch_scope(current);
 
     update_description();
@@ -1352,6 +1408,16 @@ void ConsoleWidgetPrivate::on_results_activated(const QModelIndex &index) {
     }
 }
 
+void ConsoleWidgetPrivate::on_results_scrolled_to_end() {
+    const QModelIndex current_scope = q->get_current_scope_item();
+    if (!current_scope.isValid()) {
+        return;
+    }
+
+    ConsoleImpl *impl = get_impl(current_scope);
+    impl->fetch_more(current_scope);
+}
+
 int console_item_get_type(const QModelIndex &index) {
     const int type = index.data(ConsoleRole_Type).toInt();
 
@@ -110,6 +110,15 @@ public:
     QList<QStandardItem *> add_scope_item(const int type, const QModelIndex &parent);
     QList<QStandardItem *> add_results_item(const int type, const QModelIndex &parent);
 
+    // Batch version of above f-ns, for adding many items
+    // at once. Rows are made by make_row() without being
+    // added to the model, so that setting their data
+    // doesn't emit any signals. After rows are loaded,
+    // add all of them with add_rows(). Scope is sorted only
+    // once for the whole batch.
+    QList<QStandardItem *> make_row(const int type, const QModelIndex &parent, const bool is_scope) const;
+    void add_rows(const QModelIndex &parent, const QList<QList<QStandardItem *>> &row_list);
+
     // Deletes an item and all of it's columns
     void delete_item(const QModelIndex &index);
 
@@ -120,6 +129,11 @@ public:
     // type
     void refresh_scope(const QModelIndex &index);
 
+    // Call this when an item starts or finishes loading a
+    // part of it's results, if item's impl loads results
+    // in parts. See ConsoleImpl::can_fetch_more().
+    void update_results_fetch_state(const QModelIndex &index);
+
     // Gets selected item(s) from currently focused
     // view, which could be scope or results. Only the
     // main (first column) item is returned for each
@@ -39,6 +39,8 @@ class QStandardItemModel;
 class ConsoleWidget;
 class QSplitter;
 class ConsoleImpl;
+class ConsoleItemIndex;
+class QStandardItem;
 
 enum ConsoleRole {
     // Determines whether scope item was fetched
@@ -63,6 +65,7 @@ public:
 
     QTreeView *scope_view;
     ConsoleDragModel *model;
+    ConsoleItemIndex *item_index;
     ScopeProxyModel *scope_proxy_model;
     QWidget *description_bar;
     QLabel *description_bar_left;
@@ -96,10 +99,12 @@ public:
     void drop(const QModelIndex &target);
     void set_results_to_type(const ResultsViewType type);
     void fetch_scope(const QModelIndex &index);
+    void update_results_fetch_state();
     ConsoleImpl *get_current_scope_impl() const;
     ConsoleImpl *get_impl(const QModelIndex &index) const;
     void update_description();
     QList<QModelIndex> get_all_selected_items() const;
+    bool item_is_in_subtree(QStandardItem *item, const QModelIndex &parent) const;
     QList<QAction *> get_custom_action_list() const;
     void open_context_menu(const QPoint &global_pos);
     void add_actions(QMenu *menu);
@@ -124,6 +129,7 @@ public slots:
     void on_scope_context_menu(const QPoint &pos);
     void on_scope_expanded(const QModelIndex &index);
     void on_results_activated(const QModelIndex &index);
+    void on_results_scrolled_to_end();
 };
 
 #endif /* CONSOLE_WIDGET_P_H */
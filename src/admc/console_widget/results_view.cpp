@@ -22,6 +22,7 @@
 
 #include <QHeaderView>
 #include <QListView>
+#include <QScrollBar>
 #include <QSortFilterProxyModel>
 #include <QStackedWidget>
 #include <QTreeView>
@@ -51,6 +52,8 @@ ResultsView::ResultsView(QWidget *parent)
     proxy_model = new QSortFilterProxyModel(this);
     proxy_model->setSortCaseSensitivity(Qt::CaseInsensitive);
 
+    sorting_locked = false;
+
     // Perform common setup on child views
     for (auto view : views.values()) {
         view->setEditTriggers(QAbstractItemView::NoEditTriggers);
@@ -91,6 +94,19 @@ ResultsView::ResultsView(QWidget *parent)
         connect(
             view, &QWidget::customContextMenuRequested,
             this, &ResultsView::context_menu);
+
+        QScrollBar *scroll_bar = view->verticalScrollBar();
+        connect(
+            scroll_bar, &QScrollBar::valueChanged,
+            this,
+            [this, view, scroll_bar](const int value) {
+                const bool is_current = (view == current_view());
+                const bool at_end = (value == scroll_bar->maximum());
+
+                if (is_current && at_end) {
+                    emit scrolled_to_end();
+                }
+            });
     }
 
     set_view_type(ResultsViewType_Detail);
@@ -175,6 +191,10 @@ void ResultsView::restore_state(const QVariant &state_variant, const QList<int>
         const QByteArray header_state = state["header"].toByteArray();
         header->restoreState(header_state);
 
+        // NOTE: state might've been saved while sorting
+        // was locked, so reapply sorting state to header
+        m_detail_view->setSortingEnabled(!sorting_locked);
+
         const ResultsViewType view_type = (ResultsViewType) state["view_type"].toInt();
         set_view_type(view_type);
     } else {
@@ -218,3 +238,34 @@ void ResultsView::set_drag_drop_enabled(const bool enabled) {
         view->setDragDropMode(mode);
     }
 }
+
+void ResultsView::set_sorting_locked(const bool locked) {
+    if (locked == sorting_locked) {
+        return;
+    }
+
+    sorting_locked = locked;
+
+    // NOTE: disabling sorting keeps header's sort
+    // indicator, so when sorting is enabled again, view
+    // sorts by user's column again
+    m_detail_view->setSortingEnabled(!locked);
+
+    if (locked) {
+        proxy_model->sort(0, Qt::AscendingOrder);
+    }
+}
+
+bool ResultsView::is_scrolled_to_end() const {
+    QAbstractItemView *view = current_view();
+
+    // NOTE: layout of items is delayed after they are
+    // added, so need to do it now to get correct
+    // scrollbar range
+    view->doItemsLayout();
+
+    const QScrollBar *scroll_bar = view->verticalScrollBar();
+    const bool out = (scroll_bar->value() == scroll_bar->maximum());
+
+    return out;
+}
@@ -69,17 +69,30 @@ public:
 
     void set_drag_drop_enabled(const bool enabled);
 
+    // While sorting is locked, results are sorted by first
+    // column in ascending order and user can't change
+    // sorting. User's sorting is restored after unlock.
+    void set_sorting_locked(const bool locked);
+
+    // Returns true if current view is scrolled to the end
+    // or if all of it's contents fit without scrolling
+    bool is_scrolled_to_end() const;
+
 signals:
     void activated(const QModelIndex &index);
     void context_menu(const QPoint pos);
     void selection_changed();
 
+    // Emitted when current view is scrolled to the end
+    void scrolled_to_end();
+
 private:
     QStackedWidget *stacked_widget;
     QHash<ResultsViewType, QAbstractItemView *> views;
     QSortFilterProxyModel *proxy_model;
     ResultsViewType m_current_view_type;
     QTreeView *m_detail_view;
+    bool sorting_locked;
 
     void on_item_activated(const QModelIndex &index);
 };
@@ -161,9 +161,10 @@ void FindWidget::find() {
     const QList<QString> search_attributes = console_object_search_attributes();
 
     auto find_thread = new SearchThread(base, SearchScope_All, filter, search_attributes);
+    find_thread->set_make_row_data(true);
 
     connect(
-        find_thread, &SearchThread::results_ready,
+        find_thread, &SearchThread::row_data_ready,
         this, &FindWidget::handle_find_thread_results);
     connect(
         this, &QObject::destroyed,
@@ -199,14 +200,20 @@ void FindWidget::find() {
     find_thread->start();
 }
 
-void FindWidget::handle_find_thread_results(const QHash<QString, AdObject> &results) {
+void FindWidget::handle_find_thread_results(const QList<ObjectRowData> &row_data_list) {
     const QModelIndex head_index = head_item->index();
 
-    for (const AdObject &object : results) {
-        const QList<QStandardItem *> row = ui->console->add_results_item(ItemType_Object, head_index);
+    QList<QList<QStandardItem *>> row_list;
 
-        console_object_load(row, object);
+    for (const ObjectRowData &row_data : row_data_list) {
+        const QList<QStandardItem *> row = ui->console->make_row(ItemType_Object, head_index, false);
+
+        console_object_load(row, row_data);
+
+        row_list.append(row);
     }
+
+    ui->console->add_rows(head_index, row_list);
 }
 
 QList<QString> FindWidget::get_selected_dns() const {
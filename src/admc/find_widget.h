@@ -34,6 +34,7 @@ class AdObject;
 class QMenu;
 class ObjectImpl;
 class ConsoleWidget;
+class ObjectRowData;
 
 namespace Ui {
 class FindWidget;
@@ -68,7 +69,7 @@ public:
 
 private slots:
     void find();
-    void handle_find_thread_results(const QHash<QString, AdObject> &results);
+    void handle_find_thread_results(const QList<ObjectRowData> &row_data_list);
 
 private:
     ObjectImpl *object_impl;
@@ -24,6 +24,7 @@
 #include "globals.h"
 #include "main_window.h"
 #include "main_window_connection_error.h"
+#include "object_row_data.h"
 #include "settings.h"
 #include "status.h"
 #include "utils.h"
@@ -38,11 +39,20 @@
 int main(int argc, char **argv) {
     Q_INIT_RESOURCE(adldap);
 
-    // NOTE: this is needed to pass this type from thread's
-    // signal in find_widget.cpp. Without doing this,
-    // passing this type from thread results in a runtime
-    // error.
+    // NOTE: this is needed to pass these types from
+    // thread's signals in find_widget.cpp. Without doing
+    // this, passing these types from thread results in a
+    // runtime error.
     qRegisterMetaType<QHash<QString, AdObject>>("QHash<QString, AdObject>");
+    qRegisterMetaType<QList<ObjectRowData>>("QList<ObjectRowData>");
+    qRegisterMetaType<QHash<QString, bool>>("QHash<QString, bool>");
+
+    // Start DC discovery as early as possible, so that it
+    // runs in parallel with the rest of app startup
+    const QString prefetch_domain = get_default_domain_from_krb5();
+    if (!prefetch_domain.isEmpty()) {
+        get_domain_hosts_prefetch(prefetch_domain, QString());
+    }
 
     QApplication app(argc, argv);
     app.setApplicationDisplayName(ADMC_APPLICATION_DISPLAY_NAME);
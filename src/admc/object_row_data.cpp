@@ -0,0 +1,116 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "object_row_data.h"
+
+#include "adldap.h"
+#include "globals.h"
+
+ObjectRowData object_row_data_make(const AdObject &object) {
+    const QList<AdAtom> columns = object_row_data_columns();
+    const QList<QString> filter_containers = g_adconfig->get_filter_containers();
+
+    return object_row_data_make(object, columns, filter_containers);
+}
+
+QList<AdAtom> object_row_data_columns() {
+    QList<AdAtom> out;
+
+    for (const QString &column : g_adconfig->get_columns()) {
+        out.append(AdAtom::find(column));
+    }
+
+    return out;
+}
+
+ObjectRowData object_row_data_make(const AdObject &object, const QList<AdAtom> &columns, const QList<QString> &filter_containers) {
+    static const AdAtom object_class_atom = AdAtom::intern(ATTRIBUTE_OBJECT_CLASS);
+
+    ObjectRowData out;
+
+    out.dn = object.get_dn();
+
+    for (const AdAtom &attribute : columns) {
+        if (!object.contains(attribute)) {
+            out.column_list.append(QString());
+
+            continue;
+        }
+
+        const QString display_value = [&]() {
+            if (attribute == object_class_atom) {
+                const QString object_class = object.get_string(attribute);
+
+                if (object_class == CLASS_GROUP) {
+                    const GroupScope scope = object.get_group_scope();
+                    const QString scope_string = group_scope_string(scope);
+
+                    const GroupType type = object.get_group_type();
+                    const QString type_string = group_type_string_adjective(type);
+
+                    return QString("%1 - %2").arg(type_string, scope_string);
+                } else {
+                    return g_adconfig->get_class_display_name(object_class);
+                }
+            } else {
+                const QByteArray value = object.get_value(attribute);
+                return attribute_display_value(attribute, value, g_adconfig);
+            }
+        }();
+
+        out.column_list.append(display_value);
+    }
+
+    out.object_classes = object.get_strings(ATTRIBUTE_OBJECT_CLASS);
+
+    const QString category_dn = object.get_string(ATTRIBUTE_OBJECT_CATEGORY);
+    out.object_category = dn_get_name(category_dn);
+
+    // NOTE: "containers" referenced here don't mean
+    // objects with "container" object class. Instead it
+    // means all the objects that can have children(some of
+    // which are not "container" class).
+    const QString object_class = object.get_string(ATTRIBUTE_OBJECT_CLASS);
+    out.is_container = filter_containers.contains(object_class);
+
+    out.cannot_move = object.get_system_flag(SystemFlagsBit_CannotMove);
+    out.cannot_rename = object.get_system_flag(SystemFlagsBit_CannotRename);
+    out.cannot_delete = object.get_system_flag(SystemFlagsBit_CannotDelete);
+    out.account_disabled = object.get_account_option(AccountOption_Disabled, g_adconfig);
+
+    return out;
+}
+
+QList<ObjectRowData> object_row_data_make_list(const QList<AdObject> &object_list) {
+    QList<ObjectRowData> out;
+
+    const QList<AdAtom> columns = object_row_data_columns();
+    const QList<QString> filter_containers = g_adconfig->get_filter_containers();
+
+    for (const AdObject &object : object_list) {
+        if (object.is_empty()) {
+            continue;
+        }
+
+        out.append(object_row_data_make(object, columns, filter_containers));
+    }
+
+    return out;
+}
@@ -0,0 +1,76 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OBJECT_ROW_DATA_H
+#define OBJECT_ROW_DATA_H
+
+/**
+ * Display data for a console row of an object. Making
+ * this data involves formatting attribute values and
+ * parsing flags, which is too slow to do on the GUI
+ * thread for big searches. Row data is made by search
+ * thread and then GUI thread only needs to create items
+ * from it. Making row data is thread-safe.
+ */
+
+#include <QList>
+#include <QMetaType>
+#include <QString>
+
+class AdObject;
+class AdAtom;
+
+class ObjectRowData {
+public:
+    QString dn;
+
+    // Display strings for object columns, in order of
+    // columns. Null string if object doesn't have the
+    // attribute.
+    QList<QString> column_list;
+
+    QList<QString> object_classes;
+
+    // Object category is used as icon key, icon itself
+    // has to be created in GUI thread
+    QString object_category;
+
+    // Whether object can have children, which means that
+    // it should be shown in scope
+    bool is_container = false;
+
+    bool cannot_move = false;
+    bool cannot_rename = false;
+    bool cannot_delete = false;
+    bool account_disabled = false;
+};
+
+Q_DECLARE_METATYPE(ObjectRowData)
+
+ObjectRowData object_row_data_make(const AdObject &object);
+
+// NOTE: version for making many rows at once. Column
+// atoms and filter containers are fetched once by caller
+// instead of for every object.
+QList<AdAtom> object_row_data_columns();
+ObjectRowData object_row_data_make(const AdObject &object, const QList<AdAtom> &columns, const QList<QString> &filter_containers);
+QList<ObjectRowData> object_row_data_make_list(const QList<AdObject> &object_list);
+
+#endif /* OBJECT_ROW_DATA_H */
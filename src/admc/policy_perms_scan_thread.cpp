@@ -0,0 +1,146 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "policy_perms_scan_thread.h"
+
+#include "adldap.h"
+#include "globals.h"
+
+#include <QMutex>
+#include <QSet>
+
+class PolicyPermsCacheEntry {
+public:
+    QString version;
+    bool perms_ok;
+};
+
+// NOTE: cache is shared between scan threads, so that each
+// refresh of policy tree doesn't reread all GPT's
+static QMutex perms_cache_mutex;
+static QHash<QString, PolicyPermsCacheEntry> perms_cache;
+
+// NOTE: only accessed from GUI thread
+static QSet<QString> perms_mismatch_set;
+
+PolicyPermsScanThread::PolicyPermsScanThread() {
+}
+
+void PolicyPermsScanThread::run() {
+    AdInterface ad;
+    if (!ad.is_connected()) {
+        return;
+    }
+
+    // First load only attributes which identify the
+    // version of each GPC, to find out which policies
+    // need to be checked again
+    const QString base = g_adconfig->domain_dn();
+    const QString filter = filter_CONDITION(Condition_Equals, ATTRIBUTE_OBJECT_CLASS, CLASS_GP_CONTAINER);
+    const QList<QString> version_attributes = {
+        ATTRIBUTE_WHEN_CHANGED,
+        ATTRIBUTE_VERSION_NUMBER,
+    };
+    const QHash<QString, AdObject> version_results = ad.search(base, SearchScope_All, filter, version_attributes);
+
+    QHash<QString, bool> out;
+    QHash<QString, QString> version_map;
+    QList<QString> stale_list;
+
+    {
+        QMutexLocker locker(&perms_cache_mutex);
+
+        for (const AdObject &object : version_results) {
+            const QString dn = object.get_dn();
+            const QString version = QString("%1;%2").arg(object.get_string(ATTRIBUTE_WHEN_CHANGED), object.get_string(ATTRIBUTE_VERSION_NUMBER));
+
+            version_map[dn] = version;
+
+            const bool is_cached = (perms_cache.contains(dn) && perms_cache[dn].version == version);
+            if (is_cached) {
+                out[dn] = perms_cache[dn].perms_ok;
+            } else {
+                stale_list.append(dn);
+            }
+        }
+    }
+
+    if (!stale_list.isEmpty()) {
+        const QList<QString> gpc_attributes = {
+            ATTRIBUTE_GPC_FILE_SYS_PATH,
+            ATTRIBUTE_SECURITY_DESCRIPTOR,
+        };
+        const bool get_sacl = true;
+        const QHash<QString, AdObject> gpc_map = ad.search_objects(stale_list, gpc_attributes, get_sacl);
+
+        const QHash<QString, bool> check_results = ad.gpo_check_perms_list(gpc_map.values());
+
+        QMutexLocker locker(&perms_cache_mutex);
+
+        for (const QString &dn : check_results.keys()) {
+            const bool perms_ok = check_results[dn];
+
+            PolicyPermsCacheEntry entry;
+            entry.version = version_map[dn];
+            entry.perms_ok = perms_ok;
+            perms_cache[dn] = entry;
+
+            out[dn] = perms_ok;
+        }
+    }
+
+    emit results_ready(out);
+}
+
+void policy_perms_scan_load_results(const QHash<QString, bool> &results) {
+    for (const QString &dn : results.keys()) {
+        const bool perms_ok = results[dn];
+
+        if (perms_ok) {
+            perms_mismatch_set.remove(dn);
+        } else {
+            perms_mismatch_set.insert(dn);
+        }
+    }
+}
+
+bool policy_perms_mismatch(const QString &dn) {
+    return perms_mismatch_set.contains(dn);
+}
+
+void policy_perms_scan_clear(const QString &dn) {
+    perms_mismatch_set.remove(dn);
+
+    // NOTE: syncing changes GPT but not GPC, so version of
+    // GPC stays the same and cached result has to be
+    // dropped explicitly
+    {
+        QMutexLocker locker(&perms_cache_mutex);
+        perms_cache.remove(dn);
+    }
+
+    emit policy_perms_scan_notifier()->cleared(dn);
+}
+
+PolicyPermsScanNotifier *policy_perms_scan_notifier() {
+    static PolicyPermsScanNotifier notifier;
+
+    return &notifier;
+}
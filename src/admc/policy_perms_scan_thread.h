@@ -0,0 +1,76 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POLICY_PERMS_SCAN_THREAD_H
+#define POLICY_PERMS_SCAN_THREAD_H
+
+/**
+ * A thread that checks whether GPT permissions of all
+ * policies in the domain match permissions of their GPC's.
+ * results_ready() returns a map of policy dn => whether
+ * permissions match. Results are cached by GPC's
+ * whenChanged and versionNumber, so repeated scans only
+ * read GPT's of policies that changed since last scan.
+ * GPT's are read in parallel. Note that creator of thread
+ * should call thread's deleteLater() in the finished()
+ * slot.
+ */
+
+#include <QHash>
+#include <QThread>
+
+class PolicyPermsScanThread final : public QThread {
+    Q_OBJECT
+
+public:
+    PolicyPermsScanThread();
+
+signals:
+    void results_ready(const QHash<QString, bool> &results);
+
+private:
+    void run() override;
+};
+
+// Emits cleared() when result of a policy is cleared
+// outside of a scan, for example by the security tab of
+// a properties dialog, so that consoles can update
+// badges of that policy
+class PolicyPermsScanNotifier final : public QObject {
+    Q_OBJECT
+
+signals:
+    void cleared(const QString &dn);
+};
+
+PolicyPermsScanNotifier *policy_perms_scan_notifier();
+
+// Results of scans, used to display badges on policy
+// items. NOTE: these f-ns should only be called from the
+// GUI thread.
+void policy_perms_scan_load_results(const QHash<QString, bool> &results);
+bool policy_perms_mismatch(const QString &dn);
+
+// Call after permissions of a policy were synced, to
+// remove the mismatch and make next scan check policy
+// again. Badges are updated through the notifier.
+void policy_perms_scan_clear(const QString &dn);
+
+#endif /* POLICY_PERMS_SCAN_THREAD_H */
@@ -115,6 +115,34 @@ bool PropertiesMultiDialog::apply() {
 
     show_busy_indicator();
 
+    // NOTE: consecutive edits that support batches are
+    // applied to all targets together, so that all their
+    // changes for one target are done in one
+    // modification. Batch is flushed before applying an
+    // edit that doesn't support batches, so edits are
+    // still applied in order.
+    AdModifyBatch batch;
+    QList<AttributeEdit *> batch_edit_list;
+
+    auto apply_batch = [&]() {
+        if (batch.is_empty()) {
+            return true;
+        }
+
+        const bool success = ad.modify_batch(batch);
+
+        if (success) {
+            for (AttributeEdit *edit : batch_edit_list) {
+                check_map[edit]->setChecked(false);
+            }
+        }
+
+        batch = AdModifyBatch();
+        batch_edit_list.clear();
+
+        return success;
+    };
+
     const bool apply_success = [&]() {
         bool out = true;
 
@@ -122,27 +150,53 @@ bool PropertiesMultiDialog::apply() {
             QCheckBox *apply_check = check_map[edit];
             const bool need_to_apply = apply_check->isChecked();
 
-            if (need_to_apply) {
-                const bool success = [&]() {
-                    bool success_out = true;
+            if (!need_to_apply) {
+                continue;
+            }
 
-                    for (const QString &target : target_list) {
-                        const bool this_success = edit->apply(ad, target);
+            const bool added_to_batch = [&]() {
+                for (const QString &target : target_list) {
+                    const bool added = edit->apply_to_batch(&batch, target);
 
-                        success_out = (success_out && this_success);
+                    if (!added) {
+                        return false;
                     }
+                }
 
-                    return success_out;
-                }();
+                return true;
+            }();
 
-                if (success) {
-                    apply_check->setChecked(false);
+            if (added_to_batch) {
+                batch_edit_list.append(edit);
+
+                continue;
+            }
+
+            const bool batch_success = apply_batch();
+            out = (out && batch_success);
+
+            const bool success = [&]() {
+                bool success_out = true;
+
+                for (const QString &target : target_list) {
+                    const bool this_success = edit->apply(ad, target);
+
+                    success_out = (success_out && this_success);
                 }
 
-                out = (out && success);
+                return success_out;
+            }();
+
+            if (success) {
+                apply_check->setChecked(false);
             }
+
+            out = (out && success);
         }
 
+        const bool batch_success = apply_batch();
+        out = (out && batch_success);
+
         return out;
     }();
 
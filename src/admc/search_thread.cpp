@@ -28,13 +28,18 @@
 #include <QHash>
 
 SearchThread::SearchThread(const QString base_arg, const SearchScope scope_arg, const QString &filter_arg, const QList<QString> attributes_arg) {
-    stop_flag = false;
+    stop_flag.storeRelease(0);
+    make_row_data = false;
     base = base_arg;
     scope = scope_arg;
     filter = filter_arg;
     attributes = attributes_arg;
     m_failed_to_connect = false;
+    m_failed_to_load_window = false;
     m_hit_object_display_limit = false;
+    fetch_on_demand = false;
+    vlv_offset = 0;
+    vlv_resume_offset = 0;
 
     static int id_max = 0;
     id = id_max;
@@ -42,7 +47,30 @@ SearchThread::SearchThread(const QString base_arg, const SearchScope scope_arg,
 }
 
 void SearchThread::stop() {
-    stop_flag = true;
+    stop_flag.storeRelease(1);
+}
+
+// NOTE: should be called before starting the thread
+void SearchThread::set_make_row_data(const bool value) {
+    make_row_data = value;
+}
+
+// NOTE: should be called before starting the thread
+void SearchThread::set_fetch_on_demand(const bool value) {
+    fetch_on_demand = value;
+}
+
+// NOTE: should be called before starting the thread
+void SearchThread::set_vlv_offset(const int offset) {
+    vlv_offset = offset;
+}
+
+// NOTE: should be called before starting the thread.
+// Objects matching this filter are loaded only by the
+// thread that starts from the first window, so pass the
+// same filter to threads that continue from an offset.
+void SearchThread::set_load_all_filter(const QString &filter_arg) {
+    load_all_filter = filter_arg;
 }
 
 void SearchThread::run() {
@@ -53,38 +81,167 @@ void SearchThread::run() {
         return;
     }
 
-    AdCookie cookie;
+    // NOTE: interface checks stop flag while waiting for
+    // results and abandons the search once it's set
+    ad.set_cancel_flag(&stop_flag);
 
     const int object_display_limit = settings_get_variant(SETTING_object_display_limit).toInt();
 
+    const QString window_filter = [&]() {
+        if (load_all_filter.isEmpty()) {
+            return filter;
+        } else {
+            return filter_AND({filter, filter_NOT(load_all_filter)});
+        }
+    }();
+
+    if (!load_all_filter.isEmpty() && vlv_offset == 0) {
+        const QString filter_all = filter_AND({filter, load_all_filter});
+
+        const bool success = run_paged(ad, filter_all, object_display_limit);
+
+        if (!success) {
+            return;
+        }
+    }
+
+    // NOTE: for children of a container, try to load
+    // objects in sorted windows first. This way huge
+    // containers are transferred only up to the display
+    // limit. Fall back to regular paged search if server
+    // doesn't support vlv or sorting.
+    if (scope == SearchScope_Children) {
+        const bool vlv_success = run_vlv(ad, window_filter, object_display_limit);
+
+        // NOTE: don't fall back to paged search if vlv
+        // failed because search was stopped
+        if (vlv_success || ad.is_cancelled()) {
+            return;
+        }
+    }
+
+    run_paged(ad, window_filter, object_display_limit);
+}
+
+// Returns false if search failed or was stopped
+bool SearchThread::run_paged(AdInterface &ad, const QString &filter_arg, const int object_display_limit) {
+    AdCookie cookie;
+
     int total_results_count = 0;
 
     while (true) {
         QHash<QString, AdObject> results;
 
-        const bool success = ad.search_paged(base, scope, filter, attributes, &results, &cookie);
+        const bool success = ad.search_paged(base, scope, filter_arg, attributes, &results, &cookie);
 
         total_results_count += results.count();
 
         if (total_results_count > object_display_limit) {
             m_hit_object_display_limit = true;
 
-            break;
+            return false;
         }
 
         ad_messages = ad.messages();
 
-        emit results_ready(results);
+        emit_results(results.values());
 
-        const bool search_interrupted = (!success || stop_flag);
+        const bool search_interrupted = (!success || ad.is_cancelled());
         if (search_interrupted) {
-            break;
+            return false;
         }
 
         if (!cookie.more_pages()) {
+            return true;
+        }
+    }
+}
+
+bool SearchThread::run_vlv(AdInterface &ad, const QString &filter_arg, const int object_display_limit) {
+    // NOTE: same context is passed to all windows, so
+    // that server can continue from previous window
+    AdVlvContext context;
+    int offset = vlv_offset;
+
+    while (true) {
+        const int window_size = qMin(SEARCH_THREAD_VLV_WINDOW_SIZE, object_display_limit - offset);
+        if (window_size <= 0) {
+            break;
+        }
+
+        QList<AdObject> window;
+        const bool success = ad.search_vlv(base, scope, filter_arg, attributes, ATTRIBUTE_NAME, offset, window_size, &window, &context);
+
+        if (!success) {
+            // NOTE: if vlv failed on first window, then
+            // nothing was loaded yet and caller can fall
+            // back to paged search. Otherwise report that
+            // the rest of objects failed to load.
+            const bool nothing_loaded = (offset == 0);
+
+            if (nothing_loaded) {
+                return false;
+            }
+
+            if (!ad.is_cancelled()) {
+                m_failed_to_load_window = true;
+            }
+
+            break;
+        }
+
+        ad_messages = ad.messages();
+
+        emit_results(window);
+
+        offset += window.size();
+
+        const int content_count = context.content_count();
+
+        if (offset >= content_count || window.isEmpty() || ad.is_cancelled()) {
+            break;
+        }
+
+        if (content_count > object_display_limit && offset >= object_display_limit) {
+            m_hit_object_display_limit = true;
+
+            break;
+        }
+
+        // NOTE: don't keep the connection and server's
+        // sort state while waiting for user to scroll.
+        // Next window is loaded by a new thread, which
+        // starts from this offset.
+        if (fetch_on_demand) {
+            vlv_resume_offset = offset;
+
             break;
         }
     }
+
+    return true;
+}
+
+// NOTE: row data is made here, in the search thread, so
+// that GUI thread only has to create items
+void SearchThread::emit_results(const QList<AdObject> &object_list) {
+    if (make_row_data) {
+        const QList<ObjectRowData> row_data_list = object_row_data_make_list(object_list);
+
+        emit row_data_ready(row_data_list);
+    } else {
+        const QHash<QString, AdObject> results = [&]() {
+            QHash<QString, AdObject> out;
+
+            for (const AdObject &object : object_list) {
+                out.insert(object.get_dn(), object);
+            }
+
+            return out;
+        }();
+
+        emit results_ready(results);
+    }
 }
 
 int SearchThread::get_id() const {
@@ -95,6 +252,14 @@ bool SearchThread::failed_to_connect() const {
     return m_failed_to_connect;
 }
 
+bool SearchThread::failed_to_load_window() const {
+    return m_failed_to_load_window;
+}
+
+int SearchThread::get_vlv_resume_offset() const {
+    return vlv_resume_offset;
+}
+
 bool SearchThread::hit_object_display_limit() const {
     return m_hit_object_display_limit;
 }
@@ -106,6 +271,8 @@ QList<AdMessage> SearchThread::get_ad_messages() const {
 void search_thread_display_errors(SearchThread *thread, QWidget *parent) {
     if (thread->failed_to_connect()) {
         error_log({QCoreApplication::translate("object_impl.cpp", "Failed to connect to server while searching for objects.")}, parent);
+    } else if (thread->failed_to_load_window()) {
+        error_log({QCoreApplication::translate("object_impl.cpp", "Failed to load some of the objects. Refresh to try again.")}, parent);
     } else if (thread->hit_object_display_limit()) {
         error_log({QCoreApplication::translate("object_impl.cpp", "Could not load all objects. Increase object display limit in Filter Options or reduce number of objects by applying a filter. Filter Options is accessible from main window's menubar via the \"View\" menu.")}, parent);
     }
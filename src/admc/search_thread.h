@@ -27,19 +27,39 @@
  * regular small searches this is overkill. results_ready()
  * signal returns search results as they arrive. If search
  * has multiple pages, then results_ready() will be emitted
- * multiple times. Use stop() to stop search. Note that search is
- * not stopped immediately but when current results page is
- * done processing. Note that creator of thread should call
+ * multiple times. Children of a container are loaded in
+ * windows sorted by name, using virtual list view if
+ * server supports it, so only objects up to display limit
+ * are transferred. If set_fetch_on_demand() is enabled,
+ * then thread loads only one window and finishes. Use
+ * get_vlv_resume_offset() to start another thread for
+ * the next window. Objects that match the filter given
+ * to set_load_all_filter() are loaded fully, before
+ * windows, and windows contain only the rest of objects.
+ * If set_make_row_data() is enabled,
+ * then row_data_ready() is emitted instead of
+ * results_ready() and contains console row data
+ * prepared in the thread. Use stop() to stop search. Stop
+ * is safe to call from any thread. Search in progress is
+ * abandoned on the server, so thread finishes shortly
+ * after, without waiting for current results page. Note
+ * that creator of thread should call
  * thread's deleteLater() in the finished() slot.
  */
 
+#include <QAtomicInt>
 #include <QThread>
 
 #include "ad_defines.h"
+#include "object_row_data.h"
 
+class AdInterface;
 class AdObject;
 class AdMessage;
 
+// Number of objects loaded per vlv window
+#define SEARCH_THREAD_VLV_WINDOW_SIZE 200
+
 class SearchThread final : public QThread {
     Q_OBJECT
 
@@ -47,27 +67,49 @@ public:
     SearchThread(const QString base, const SearchScope scope, const QString &filter, const QList<QString> attributes);
 
     void stop();
+    void set_make_row_data(const bool value);
+    void set_fetch_on_demand(const bool value);
+    void set_vlv_offset(const int offset);
+    void set_load_all_filter(const QString &filter);
     int get_id() const;
     bool failed_to_connect() const;
+    bool failed_to_load_window() const;
     bool hit_object_display_limit() const;
+
+    // Returns position of next window, if thread fetches
+    // on demand and there are still objects left. Pass it
+    // to set_vlv_offset() of a new thread to continue.
+    // Returns 0 otherwise.
+    int get_vlv_resume_offset() const;
+
     QList<AdMessage> get_ad_messages() const;
 
 signals:
     void results_ready(const QHash<QString, AdObject> &results);
+    void row_data_ready(const QList<ObjectRowData> &row_data_list);
     void over_object_display_limit();
 
 private:
-    bool stop_flag;
+    QAtomicInt stop_flag;
+    bool make_row_data;
     QString base;
     SearchScope scope;
     QString filter;
     QList<QString> attributes;
     int id;
     bool m_failed_to_connect;
+    bool m_failed_to_load_window;
     bool m_hit_object_display_limit;
     QList<AdMessage> ad_messages;
+    bool fetch_on_demand;
+    int vlv_offset;
+    int vlv_resume_offset;
+    QString load_all_filter;
 
     void run() override;
+    bool run_paged(AdInterface &ad, const QString &filter_arg, const int object_display_limit);
+    bool run_vlv(AdInterface &ad, const QString &filter_arg, const int object_display_limit);
+    void emit_results(const QList<AdObject> &object_list);
 };
 
 // Call this in your finished() slot to display any
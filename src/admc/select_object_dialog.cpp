@@ -224,18 +224,26 @@ void SelectObjectDialog::add_objects_to_list(const QList<QString> &dn_list, AdIn
 
     bool any_duplicates = false;
 
+    QList<QString> dn_to_add_list;
+
     for (const QString &dn : dn_list) {
         const bool is_duplicate = current_selected_list.contains(dn);
 
         if (is_duplicate) {
             any_duplicates = true;
         } else {
-            const AdObject object = ad.search_object(dn);
-
-            add_select_object_to_model(model, object);
+            dn_to_add_list.append(dn);
         }
     }
 
+    const QHash<QString, AdObject> object_map = ad.search_objects(dn_to_add_list, console_object_search_attributes());
+
+    for (const QString &dn : dn_to_add_list) {
+        const AdObject object = object_map.value(dn);
+
+        add_select_object_to_model(model, object);
+    }
+
     if (any_duplicates) {
         message_box_warning(this, tr("Error"), tr("Selected object is already in the list."));
     }
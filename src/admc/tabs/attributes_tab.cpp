@@ -221,11 +221,7 @@ void AttributesTabEdit::edit_attribute() {
 void AttributesTabEdit::load(AdInterface &ad, const AdObject &object) {
     UNUSED_ARG(ad);
 
-    original.clear();
-
-    for (auto attribute : object.attributes()) {
-        original[attribute] = object.get_values(attribute);
-    }
+    original = object.get_attributes_data();
 
     // Add attributes without values
     const QList<QString> object_classes = object.get_strings(ATTRIBUTE_OBJECT_CLASS);
@@ -270,8 +266,9 @@ bool AttributesTabEdit::apply(AdInterface &ad, const QString &target) const {
 }
 
 void AttributesTabEdit::load_row(const QList<QStandardItem *> &row, const QString &attribute, const QList<QByteArray> &values) {
-    const QString display_values = attribute_display_values(attribute, values, g_adconfig);
-    const AttributeType type = g_adconfig->get_attribute_type(attribute);
+    const AdAtom attribute_atom = AdAtom::find(attribute);
+    const QString display_values = attribute_display_values(attribute_atom, values, g_adconfig);
+    const AttributeType type = g_adconfig->get_attribute_type(attribute_atom);
     const QString type_display = attribute_type_display_string(type);
 
     row[AttributesColumn_Name]->setText(attribute);
@@ -61,8 +61,9 @@ void AttributesTabProxy::load(const AdObject &object) {
 bool AttributesTabProxy::filterAcceptsRow(int source_row, const QModelIndex &source_parent) const {
     auto source = sourceModel();
     const QString attribute = source->index(source_row, AttributesColumn_Name, source_parent).data().toString();
+    const AdAtom attribute_atom = AdAtom::find(attribute);
 
-    const bool system_only = g_adconfig->get_attribute_is_system_only(attribute);
+    const bool system_only = g_adconfig->get_attribute_is_system_only(attribute_atom);
     const bool unset = !set_attributes.contains(attribute);
     const bool mandatory = mandatory_attributes.contains(attribute);
     const bool optional = optional_attributes.contains(attribute);
@@ -80,8 +81,8 @@ bool AttributesTabProxy::filterAcceptsRow(int source_row, const QModelIndex &sou
     }
 
     if (filter_menu->filter_is_enabled(AttributeFilter_ReadOnly) && system_only) {
-        const bool constructed = g_adconfig->get_attribute_is_constructed(attribute);
-        const bool backlink = g_adconfig->get_attribute_is_backlink(attribute);
+        const bool constructed = g_adconfig->get_attribute_is_constructed(attribute_atom);
+        const bool backlink = g_adconfig->get_attribute_is_backlink(attribute_atom);
 
         if (!filter_menu->filter_is_enabled(AttributeFilter_SystemOnly) && !constructed && !backlink) {
             return false;
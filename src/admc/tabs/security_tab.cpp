@@ -24,6 +24,7 @@
 #include "ad_security.h"
 #include "adldap.h"
 #include "globals.h"
+#include "policy_perms_scan_thread.h"
 #include "select_object_dialog.h"
 #include "select_well_known_trustee_dialog.h"
 #include "settings.h"
@@ -335,6 +336,7 @@ void SecurityTabEdit::load_rights_model() {
     ignore_item_changed_signal = true;
 
     const QByteArray trustee = get_current_trustee();
+    const SecurityRightIndex right_index = SecurityRightIndex(sd, trustee);
 
     for (int row = 0; row < rights_model->rowCount(); row++) {
         const SecurityRightState state = [&]() {
@@ -342,7 +344,7 @@ void SecurityTabEdit::load_rights_model() {
             const uint32_t access_mask = item->data(RightsItemRole_AccessMask).toUInt();
 
             const QByteArray object_type = item->data(RightsItemRole_ObjectType).toByteArray();
-            const SecurityRightState out = security_descriptor_get_right(sd, trustee, access_mask, object_type);
+            const SecurityRightState out = right_index.get(access_mask, object_type);
 
             return out;
         }();
@@ -462,8 +464,20 @@ bool SecurityTabEdit::apply(AdInterface &ad, const QString &target) const {
 
     total_success = (total_success && ad_security_replace_security_descriptor(ad, target, sd));
 
-    if (is_policy) {
-        total_success = (total_success && ad.gpo_sync_perms(target));
+    if (is_policy && total_success) {
+        // NOTE: clearing scan result also updates badges,
+        // see PolicyPermsScanNotifier
+        auto on_sync_success = [target]() {
+            policy_perms_scan_clear(target);
+        };
+
+        const bool sync_success = gpo_sync_perms_with_progress(ad, target, ui->trustee_view, on_sync_success);
+
+        if (sync_success) {
+            on_sync_success();
+        }
+
+        total_success = sync_success;
     }
 
     return total_success;
@@ -558,6 +572,8 @@ void SecurityTabEdit::add_trustees(const QList<QByteArray> &sid_list, AdInterfac
     bool added_anything = false;
     bool failed_to_add_because_already_exists = false;
 
+    const QHash<QByteArray, QString> name_map = ad_security_get_trustee_name_list(ad, sid_list);
+
     for (const QByteArray &sid : sid_list) {
         const QString sid_string = object_sid_display_value(sid);
         const bool trustee_already_in_list = (current_sid_string_list.contains(sid_string));
@@ -568,7 +584,7 @@ void SecurityTabEdit::add_trustees(const QList<QByteArray> &sid_list, AdInterfac
         }
 
         auto item = new QStandardItem();
-        const QString name = ad_security_get_trustee_name(ad, sid);
+        const QString name = name_map.value(sid);
         item->setText(name);
         item->setData(sid, TrusteeItemRole_Sid);
         trustee_model->appendRow(item);
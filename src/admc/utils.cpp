@@ -42,6 +42,7 @@
 #include <QPersistentModelIndex>
 #include <QPlainTextEdit>
 #include <QPoint>
+#include <QProgressDialog>
 #include <QScreen>
 #include <QSortFilterProxyModel>
 #include <QStandardItem>
@@ -50,6 +51,7 @@
 
 QMessageBox *message_box_generic(const QMessageBox::Icon icon, const QString &title, const QString &text, QWidget *parent);
 int get_range_upper(const QString &attribute);
+bool gpo_sync_perms_attempt(AdInterface &ad, const QString &gpo, const QList<QString> &resume_list, QWidget *parent, const std::function<void()> &on_retry_success);
 
 QList<QStandardItem *> make_item_row(const int count) {
     QList<QStandardItem *> row;
@@ -197,7 +199,35 @@ QIcon get_object_icon(const AdObject &object) {
     return out;
 }
 
+// NOTE: icon caches are only used from GUI thread, same as
+// icons themselves. Caches are cleared when icon theme
+// changes because cached icons belong to previous theme.
+static QHash<QString, QIcon> object_icon_cache;
+static QHash<QString, QIcon> theme_icon_cache;
+static QString icon_cache_theme_name;
+
+static void icon_cache_check_theme() {
+    const QString theme_name = QIcon::themeName();
+
+    if (theme_name != icon_cache_theme_name) {
+        icon_cache_clear();
+
+        icon_cache_theme_name = theme_name;
+    }
+}
+
+void icon_cache_clear() {
+    object_icon_cache.clear();
+    theme_icon_cache.clear();
+}
+
 QIcon get_object_icon(const QString &object_category) {
+    icon_cache_check_theme();
+
+    if (object_icon_cache.contains(object_category)) {
+        return object_icon_cache[object_category];
+    }
+
     // NOTE: use a list of possible icons because
     // default icon themes for different DE's don't
     // fully intersect
@@ -240,8 +270,24 @@ QIcon get_object_icon(const QString &object_category) {
         return error_icon;
     }();
 
+    const QIcon icon = get_theme_icon(icon_name);
+
+    object_icon_cache.insert(object_category, icon);
+
+    return icon;
+}
+
+QIcon get_theme_icon(const QString &icon_name) {
+    icon_cache_check_theme();
+
+    if (theme_icon_cache.contains(icon_name)) {
+        return theme_icon_cache[icon_name];
+    }
+
     const QIcon icon = QIcon::fromTheme(icon_name);
 
+    theme_icon_cache.insert(icon_name, icon);
+
     return icon;
 }
 
@@ -514,3 +560,59 @@ int get_range_upper(const QString &attribute) {
 void set_line_edit_to_hex_numbers_only(QLineEdit *edit) {
     edit->setValidator(new QRegExpValidator(QRegExp("[0-9a-f]*"), edit));
 }
+
+bool gpo_sync_perms_with_progress(AdInterface &ad, const QString &gpo, QWidget *parent, const std::function<void()> &on_retry_success) {
+    return gpo_sync_perms_attempt(ad, gpo, QList<QString>(), parent, on_retry_success);
+}
+
+bool gpo_sync_perms_attempt(AdInterface &ad, const QString &gpo, const QList<QString> &resume_list, QWidget *parent, const std::function<void()> &on_retry_success) {
+    QList<QString> failed_list;
+
+    const bool success = [&]() {
+        // NOTE: sync runs in GUI thread, progress dialog
+        // is modal so setValue() processes events and
+        // keeps it updated
+        QProgressDialog progress_dialog(QCoreApplication::translate("utils.cpp", "Updating permissions of policy files..."), QString(), 0, 0, parent);
+        progress_dialog.setWindowModality(Qt::WindowModal);
+        progress_dialog.setCancelButton(nullptr);
+
+        auto on_progress = [&](const int done, const int total) {
+            progress_dialog.setMaximum(total);
+            progress_dialog.setValue(done);
+        };
+
+        return ad.gpo_sync_perms(gpo, on_progress, &failed_list, resume_list);
+    }();
+
+    // NOTE: failed list is empty if sync failed before
+    // processing paths, nothing to retry in that case
+    if (success || failed_list.isEmpty()) {
+        return success;
+    }
+
+    const QString title = QCoreApplication::translate("utils.cpp", "Failed to update permissions");
+    const QString text = QCoreApplication::translate("utils.cpp", "Failed to update permissions for %1 policy files or folders. Would you like to retry for the failed ones?").arg(failed_list.size());
+
+    QMessageBox *retry_dialog = message_box_warning(parent, title, text);
+    retry_dialog->setStandardButtons(QMessageBox::Retry | QMessageBox::Cancel);
+
+    QObject::connect(
+        retry_dialog, &QDialog::accepted,
+        parent,
+        [gpo, failed_list, parent, on_retry_success]() {
+            AdInterface retry_ad;
+            if (ad_failed(retry_ad, parent)) {
+                return;
+            }
+
+            const bool retry_success = gpo_sync_perms_attempt(retry_ad, gpo, failed_list, parent, on_retry_success);
+
+            g_status->display_ad_messages(retry_ad, parent);
+
+            if (retry_success && on_retry_success != nullptr) {
+                on_retry_success();
+            }
+        });
+
+    return false;
+}
@@ -21,6 +21,8 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <functional>
+
 class QAbstractItemModel;
 class QAbstractItemView;
 class QAbstractProxyModel;
@@ -94,6 +96,13 @@ void limit_plain_text_edit(QPlainTextEdit *edit, const QString &attribute);
 QIcon get_object_icon(const AdObject &object);
 QIcon get_object_icon(const QString &object_category);
 
+// Same as QIcon::fromTheme() but icons are cached. Icon
+// caches are cleared when icon theme changes. Call
+// icon_cache_clear() to reload icons manually. Use only
+// from GUI thread.
+QIcon get_theme_icon(const QString &icon_name);
+void icon_cache_clear();
+
 QList<QPersistentModelIndex> persistent_index_list(const QList<QModelIndex> &indexes);
 QList<QModelIndex> normal_index_list(const QList<QPersistentModelIndex> &indexes);
 
@@ -135,4 +144,12 @@ void setup_lineedit_autofill(QLineEdit *src, QLineEdit *dest);
 // (first name + last name) -> full name
 void setup_full_name_autofill(QLineEdit *first_name_edit, QLineEdit *last_name_edit, QLineEdit *full_name_edit);
 
+// Syncs permissions of GPO's GPT to match GPC, while
+// showing a progress dialog. If some paths fail, opens a
+// message box which offers to retry only the failed
+// paths. Retries use their own connection and display
+// their own messages. on_retry_success is called if a
+// retry succeeds. Returns result of first attempt.
+bool gpo_sync_perms_with_progress(AdInterface &ad, const QString &gpo, QWidget *parent, const std::function<void()> &on_retry_success = nullptr);
+
 #endif /* UTILS_H */
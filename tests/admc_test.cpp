@@ -31,6 +31,7 @@
 #include "filter_widget/ui_select_base_widget.h"
 #include "find_widget.h"
 #include "globals.h"
+#include "object_row_data.h"
 #include "select_container_dialog.h"
 #include "select_object_advanced_dialog.h"
 #include "select_object_dialog.h"
@@ -54,6 +55,8 @@
 
 void ADMCTest::initTestCase() {
     qRegisterMetaType<QHash<QString, AdObject>>("QHash<QString, AdObject>");
+    qRegisterMetaType<QList<ObjectRowData>>("QList<ObjectRowData>");
+    qRegisterMetaType<QHash<QString, bool>>("QHash<QString, bool>");
 
     QVERIFY2(ad.is_connected(), "Failed to connect to AD server");
 
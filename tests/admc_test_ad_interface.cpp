@@ -23,6 +23,7 @@
 #include "globals.h"
 #include "samba/dom_sid.h"
 
+#include <QAtomicInt>
 #include <QTest>
 
 #define TEST_GPO "ADMCTestAdInterface_TEST_GPO"
@@ -89,6 +90,16 @@ void ADMCTestAdInterface::create_and_gpo_delete() {
 }
 
 void ADMCTestAdInterface::gpo_check_perms() {
+    // Batch version should give same results as regular
+    // check
+    auto check_perms_list = [&](const QString &dn) {
+        const bool get_sacl = true;
+        const AdObject gpc_object = ad.search_object(dn, QList<QString>(), get_sacl);
+        const QHash<QString, bool> results = ad.gpo_check_perms_list({gpc_object});
+
+        return results.value(dn, false);
+    };
+
     QString gpc_dn;
     const bool create_success = ad.gpo_add(TEST_GPO, gpc_dn);
     QVERIFY(create_success);
@@ -98,6 +109,7 @@ void ADMCTestAdInterface::gpo_check_perms() {
     const bool perms_before = ad.gpo_check_perms(gpc_dn, &gpo_check_perms_ok_1);
     QVERIFY(gpo_check_perms_ok_1);
     QCOMPARE(perms_before, true);
+    QCOMPARE(check_perms_list(gpc_dn), true);
 
     // Change GPC perms so they don't match with GPT perms
     {
@@ -122,6 +134,7 @@ void ADMCTestAdInterface::gpo_check_perms() {
     const bool perms_after = ad.gpo_check_perms(gpc_dn, &gpo_check_perms_ok_2);
     QVERIFY(gpo_check_perms_ok_2);
     QCOMPARE(perms_after, false);
+    QCOMPARE(check_perms_list(gpc_dn), false);
 
     bool deleted_object;
     const bool delete_success = ad.gpo_delete(gpc_dn, &deleted_object);
@@ -257,4 +270,376 @@ void ADMCTestAdInterface::user_set_account_option() {
     }
 }
 
+void ADMCTestAdInterface::get_domain_hosts_cache() {
+    const QString domain = get_default_domain_from_krb5();
+
+    get_domain_hosts_clear_cache();
+    const int query_count_before = get_domain_hosts_query_count();
+    const QList<QString> hosts = get_domain_hosts(domain, QString());
+    QVERIFY(!hosts.isEmpty());
+    QVERIFY(get_domain_hosts_query_count() > query_count_before);
+
+    // Second lookup should be served from cache, without
+    // a query, and return hosts in same order
+    const int query_count_first = get_domain_hosts_query_count();
+    const QList<QString> hosts_cached = get_domain_hosts(domain, QString());
+    QCOMPARE(hosts_cached, hosts);
+    QCOMPARE(get_domain_hosts_query_count(), query_count_first);
+
+    get_domain_hosts_clear_cache();
+    const QList<QString> hosts_after_clear = get_domain_hosts(domain, QString());
+    QCOMPARE(hosts_after_clear.toSet(), hosts.toSet());
+    QVERIFY(get_domain_hosts_query_count() > query_count_first);
+}
+
+void ADMCTestAdInterface::search_concurrent() {
+    const QString user_dn = test_object_dn(TEST_USER, CLASS_USER);
+    const bool add_user_success = ad.object_add(user_dn, CLASS_USER);
+    QVERIFY(add_user_success);
+
+    const QString ou_dn = test_object_dn(TEST_OU, CLASS_OU);
+    const bool add_ou_success = ad.object_add(ou_dn, CLASS_OU);
+    QVERIFY(add_ou_success);
+
+    const QList<AdSearchArgs> args_list = [&]() {
+        AdSearchArgs user_args;
+        user_args.base = user_dn;
+        user_args.scope = SearchScope_Object;
+        user_args.attributes = {ATTRIBUTE_DN};
+
+        AdSearchArgs ou_args;
+        ou_args.base = ou_dn;
+        ou_args.scope = SearchScope_Object;
+        ou_args.attributes = {ATTRIBUTE_DN};
+
+        AdSearchArgs children_args;
+        children_args.base = test_arena_dn();
+        children_args.scope = SearchScope_Children;
+        children_args.attributes = {ATTRIBUTE_DN};
+
+        AdSearchArgs missing_args;
+        missing_args.base = test_object_dn("missing-object", CLASS_USER);
+        missing_args.scope = SearchScope_Object;
+
+        return QList<AdSearchArgs>({user_args, ou_args, children_args, missing_args});
+    }();
+
+    const QList<QHash<QString, AdObject>> results = ad.search_concurrent(args_list);
+    QCOMPARE(results.size(), args_list.size());
+
+    QVERIFY(results[0].contains(user_dn));
+    QVERIFY(results[1].contains(ou_dn));
+    QCOMPARE(results[2].keys().toSet(), QSet<QString>({user_dn, ou_dn}));
+    QVERIFY(results[3].isEmpty());
+
+    // Results should match the ones from regular search
+    const QHash<QString, AdObject> children_results = ad.search(test_arena_dn(), SearchScope_Children, QString(), {ATTRIBUTE_DN});
+    QCOMPARE(results[2].keys().toSet(), children_results.keys().toSet());
+}
+
+void ADMCTestAdInterface::search_objects() {
+    const QString user_dn = test_object_dn(TEST_USER, CLASS_USER);
+    const bool add_user_success = ad.object_add(user_dn, CLASS_USER);
+    QVERIFY(add_user_success);
+
+    const QString group_dn = test_object_dn(TEST_GROUP, CLASS_GROUP);
+    const bool add_group_success = ad.object_add(group_dn, CLASS_GROUP);
+    QVERIFY(add_group_success);
+
+    const QString missing_dn = test_object_dn("missing-object", CLASS_USER);
+
+    const QHash<QString, AdObject> results = ad.search_objects({user_dn, group_dn, missing_dn}, {ATTRIBUTE_OBJECT_CLASS});
+    QCOMPARE(results.keys().toSet(), QSet<QString>({user_dn, group_dn}));
+    QVERIFY(results[user_dn].is_class(CLASS_USER));
+    QVERIFY(results[group_dn].is_class(CLASS_GROUP));
+}
+
+void ADMCTestAdInterface::atom_lookup() {
+    const AdAtom atom = AdAtom::intern(ATTRIBUTE_OBJECT_CLASS);
+    QVERIFY(!atom.is_null());
+    QCOMPARE(AdAtom::intern(ATTRIBUTE_OBJECT_CLASS), atom);
+
+    // Atoms are case-sensitive, same as string keys
+    QVERIFY(AdAtom::find(QString(ATTRIBUTE_OBJECT_CLASS).toUpper()).is_null());
+
+    // Lookups through string overloads don't intern
+    const int count_before = AdAtom::count();
+    QCOMPARE(g_adconfig->get_attribute_display_name("ADMCTEST-never-interned", CLASS_USER), QString("ADMCTEST-never-interned"));
+    QCOMPARE(g_adconfig->get_attribute_type("ADMCTEST-never-interned"), AttributeType_StringCase);
+    QVERIFY(AdAtom::find("ADMCTEST-never-interned").is_null());
+    QCOMPARE(AdAtom::count(), count_before);
+
+    const QString user_dn = test_object_dn(TEST_USER, CLASS_USER);
+    const bool add_user_success = ad.object_add(user_dn, CLASS_USER);
+    QVERIFY(add_user_success);
+
+    const AdObject object = ad.search_object(user_dn);
+    QVERIFY(object.contains(atom));
+    QCOMPARE(object.get_string(atom), object.get_string(ATTRIBUTE_OBJECT_CLASS));
+    QCOMPARE(g_adconfig->get_attribute_type(atom), g_adconfig->get_attribute_type(ATTRIBUTE_OBJECT_CLASS));
+}
+
+void ADMCTestAdInterface::search_vlv() {
+    const QList<QString> name_list = {"vlv-c", "vlv-a", "vlv-d", "vlv-b"};
+    for (const QString &name : name_list) {
+        const QString dn = test_object_dn(name, CLASS_USER);
+        const bool add_success = ad.object_add(dn, CLASS_USER);
+        QVERIFY(add_success);
+    }
+
+    const QString filter = filter_CONDITION(Condition_Equals, ATTRIBUTE_OBJECT_CLASS, CLASS_USER);
+
+    AdVlvContext context;
+
+    QList<AdObject> window;
+    const bool success = ad.search_vlv(test_arena_dn(), SearchScope_Children, filter, {ATTRIBUTE_NAME}, ATTRIBUTE_NAME, 1, 2, &window, &context);
+    QVERIFY(success);
+
+    // Window should contain 2nd and 3rd objects in
+    // sorted order
+    QCOMPARE(context.content_count(), name_list.size());
+    QCOMPARE(window.size(), 2);
+    QCOMPARE(window[0].get_string(ATTRIBUTE_NAME), QString("vlv-b"));
+    QCOMPARE(window[1].get_string(ATTRIBUTE_NAME), QString("vlv-c"));
+
+    // Next window using context from previous one
+    QList<AdObject> next_window;
+    const bool next_success = ad.search_vlv(test_arena_dn(), SearchScope_Children, filter, {ATTRIBUTE_NAME}, ATTRIBUTE_NAME, 3, 2, &next_window, &context);
+    QVERIFY(next_success);
+    QCOMPARE(next_window.size(), 1);
+    QCOMPARE(next_window[0].get_string(ATTRIBUTE_NAME), QString("vlv-d"));
+}
+
+void ADMCTestAdInterface::modify_batch() {
+    const QString user_dn = test_object_dn(TEST_USER, CLASS_USER);
+    const bool add_user_success = ad.object_add(user_dn, CLASS_USER);
+    QVERIFY(add_user_success);
+
+    const QString user_2_dn = test_object_dn("test-user-2", CLASS_USER);
+    const bool add_user_2_success = ad.object_add(user_2_dn, CLASS_USER);
+    QVERIFY(add_user_2_success);
+
+    const QString missing_dn = test_object_dn("missing-object", CLASS_USER);
+
+    AdModifyBatch batch;
+    for (const QString &dn : {user_dn, missing_dn, user_2_dn}) {
+        batch.replace_string(dn, ATTRIBUTE_DESCRIPTION, "test-description");
+        batch.replace_string(dn, ATTRIBUTE_DEPARTMENT, "test-department");
+    }
+
+    QList<QString> failed_list;
+    const bool success = ad.modify_batch(batch, &failed_list);
+    QVERIFY(!success);
+    QCOMPARE(failed_list, QList<QString>({missing_dn}));
+
+    for (const QString &dn : {user_dn, user_2_dn}) {
+        const AdObject object = ad.search_object(dn, {ATTRIBUTE_DESCRIPTION, ATTRIBUTE_DEPARTMENT});
+        QCOMPARE(object.get_string(ATTRIBUTE_DESCRIPTION), QString("test-description"));
+        QCOMPARE(object.get_string(ATTRIBUTE_DEPARTMENT), QString("test-department"));
+    }
+}
+
+void ADMCTestAdInterface::attribute_replace_values() {
+    const QString user_dn = test_object_dn(TEST_USER, CLASS_USER);
+    const bool add_user_success = ad.object_add(user_dn, CLASS_USER);
+    QVERIFY(add_user_success);
+
+    ad.clear_messages();
+
+    // Without messages, old values are not read
+    const bool replace_success = ad.attribute_replace_string(user_dn, ATTRIBUTE_DESCRIPTION, "first", DoStatusMsg_No);
+    QVERIFY(replace_success);
+    QVERIFY(ad.messages().isEmpty());
+
+    // With old values given by caller
+    const bool replace_with_old_success = ad.attribute_replace_string(user_dn, ATTRIBUTE_DESCRIPTION, "second", "first");
+    QVERIFY(replace_with_old_success);
+
+    const AdObject object = ad.search_object(user_dn, {ATTRIBUTE_DESCRIPTION});
+    QCOMPARE(object.get_string(ATTRIBUTE_DESCRIPTION), QString("second"));
+}
+
+void ADMCTestAdInterface::object_delete_list() {
+    QList<QString> dn_list;
+    for (int i = 0; i < 3; i++) {
+        const QString dn = test_object_dn(QString("test-user-%1").arg(i), CLASS_USER);
+        const bool add_success = ad.object_add(dn, CLASS_USER);
+        QVERIFY(add_success);
+
+        dn_list.append(dn);
+    }
+
+    const QString missing_dn = test_object_dn("missing-object", CLASS_USER);
+
+    QHash<QString, bool> result_map;
+    auto on_result = [&](const QString &dn, const bool success) {
+        result_map[dn] = success;
+    };
+
+    // NOTE: use small window to test refilling it
+    const QList<QString> deleted_list = ad.object_delete_list(dn_list + QList<QString>({missing_dn}), on_result, 2);
+    QCOMPARE(deleted_list.toSet(), dn_list.toSet());
+    QCOMPARE(result_map.size(), 4);
+    QCOMPARE(result_map[missing_dn], false);
+
+    for (const QString &dn : dn_list) {
+        QVERIFY(result_map[dn]);
+        QVERIFY(!object_exists(dn));
+    }
+}
+
+void ADMCTestAdInterface::search_cancel() {
+    const QString dn = test_object_dn(TEST_USER, CLASS_USER);
+    const bool add_success = ad.object_add(dn, CLASS_USER);
+    QVERIFY(add_success);
+
+    QAtomicInt cancel_flag(0);
+    ad.set_cancel_flag(&cancel_flag);
+
+    // Search should work while flag is not set
+    const QHash<QString, AdObject> results = ad.search(test_arena_dn(), SearchScope_Children, QString(), {});
+    QVERIFY(results.contains(dn));
+
+    // Cancelled search should fail without results
+    cancel_flag.storeRelease(1);
+    QVERIFY(ad.is_cancelled());
+
+    AdCookie cookie;
+    QHash<QString, AdObject> cancelled_results;
+    const bool cancelled_success = ad.search_paged(test_arena_dn(), SearchScope_Children, QString(), {}, &cancelled_results, &cookie);
+    QVERIFY(!cancelled_success);
+    QVERIFY(cancelled_results.isEmpty());
+
+    // Connection should still be usable after cancel
+    ad.set_cancel_flag(nullptr);
+    QVERIFY(!ad.is_cancelled());
+    const QHash<QString, AdObject> results_after = ad.search(test_arena_dn(), SearchScope_Children, QString(), {});
+    QVERIFY(results_after.contains(dn));
+}
+
+void ADMCTestAdInterface::attribute_descriptors() {
+    QCOMPARE(g_adconfig->get_attribute_type(ATTRIBUTE_ACCOUNT_EXPIRES), AttributeType_LargeInteger);
+    QCOMPARE(g_adconfig->get_attribute_large_integer_subtype(ATTRIBUTE_ACCOUNT_EXPIRES), LargeIntegerSubtype_Datetime);
+    QVERIFY(g_adconfig->get_attribute_is_single_valued(ATTRIBUTE_SAM_ACCOUNT_NAME));
+    QVERIFY(g_adconfig->get_attribute_is_backlink(ATTRIBUTE_MEMBER_OF));
+    QVERIFY(!g_adconfig->get_attribute_is_backlink(ATTRIBUTE_MEMBER));
+
+    // Attributes missing from schema, including ones
+    // interned after config was loaded, should get
+    // default values
+    const QString unknown_attribute = "ADMCTEST-unknown-attribute";
+    QCOMPARE(g_adconfig->get_attribute_type(unknown_attribute), AttributeType_StringCase);
+    QCOMPARE(g_adconfig->get_attribute_large_integer_subtype(unknown_attribute), LargeIntegerSubtype_Integer);
+    QVERIFY(!g_adconfig->get_attribute_is_single_valued(unknown_attribute));
+    QCOMPARE(g_adconfig->get_attribute_range_upper(unknown_attribute), 0);
+}
+
+void ADMCTestAdInterface::cstr() {
+    const QList<QString> string_list = {
+        QString(),
+        "test",
+        QString::fromUtf8("тест \xe2\x82\xac \xf0\x9f\x98\x80"),
+        QString(1000, 'a'),
+    };
+
+    for (const QString &string : string_list) {
+        const CStr string_cstr(string);
+        const QByteArray expected = string.toUtf8();
+
+        QCOMPARE(string_cstr.size(), expected.size());
+        QCOMPARE(QByteArray(string_cstr.get()), expected);
+    }
+}
+
+void ADMCTestAdInterface::gpo_sync_perms() {
+    QString gpc_dn;
+    const bool create_success = ad.gpo_add(TEST_GPO, gpc_dn);
+    QVERIFY(create_success);
+
+    // Change GPC perms so they don't match with GPT perms
+    {
+        const AdObject gpc_object = ad.search_object(gpc_dn);
+        security_descriptor *new_sd = gpc_object.get_security_descriptor();
+        const QByteArray trustee_everyone = sid_string_to_bytes(SID_WORLD);
+        const QList<QString> class_list = gpc_object.get_strings(ATTRIBUTE_OBJECT_CLASS);
+        security_descriptor_add_right(new_sd, ad.adconfig(), class_list, trustee_everyone, SEC_ADS_GENERIC_ALL, QByteArray(), true);
+        ad_security_replace_security_descriptor(ad, gpc_dn, new_sd);
+    }
+
+    QList<int> done_list;
+    int last_total = 0;
+    QList<QString> failed_list;
+    const bool sync_success = ad.gpo_sync_perms(
+        gpc_dn,
+        [&](const int done, const int total) {
+            done_list.append(done);
+            last_total = total;
+        },
+        &failed_list);
+    QVERIFY(sync_success);
+    QVERIFY(failed_list.isEmpty());
+
+    // Progress should be reported once per level and end
+    // with all paths done
+    QVERIFY(!done_list.isEmpty());
+    QCOMPARE(done_list.last(), last_total);
+
+    bool check_ok = true;
+    const bool perms_after = ad.gpo_check_perms(gpc_dn, &check_ok);
+    QVERIFY(check_ok);
+    QVERIFY(perms_after);
+
+    bool deleted_object;
+    const bool delete_success = ad.gpo_delete(gpc_dn, &deleted_object);
+    QVERIFY(delete_success);
+}
+
+void ADMCTestAdInterface::gpo_sync_perms_resume() {
+    QString gpc_dn;
+    const bool create_success = ad.gpo_add(TEST_GPO, gpc_dn);
+    QVERIFY(create_success);
+
+    const AdObject gpc_object = ad.search_object(gpc_dn);
+    const QString gpt_path = ad.filesys_path_to_smb_path(gpc_object.get_string(ATTRIBUTE_GPC_FILE_SYS_PATH));
+
+    // Returns total number of paths that sync processed
+    auto sync_and_get_total = [&](const QList<QString> &resume_list) {
+        int total_out = 0;
+        QList<QString> failed_list;
+        const bool sync_success = ad.gpo_sync_perms(
+            gpc_dn,
+            [&](const int, const int total) {
+                total_out = total;
+            },
+            &failed_list, resume_list);
+
+        if (!sync_success || !failed_list.isEmpty()) {
+            return -1;
+        }
+
+        return total_out;
+    };
+
+    const int full_total = sync_and_get_total(QList<QString>());
+    QVERIFY(full_total > 0);
+
+    // Resuming from a subfolder should only process that
+    // subfolder and it's contents
+    const int machine_total = sync_and_get_total({gpt_path + "/Machine"});
+    QVERIFY(machine_total >= 1);
+    QVERIFY(machine_total < full_total);
+
+    // Resuming from root should process everything
+    const int root_total = sync_and_get_total({gpt_path});
+    QCOMPARE(root_total, full_total);
+
+    // Paths that are not in GPT are ignored
+    const int missing_total = sync_and_get_total({gpt_path + "/missing-folder"});
+    QCOMPARE(missing_total, 0);
+
+    bool deleted_object;
+    const bool delete_success = ad.gpo_delete(gpc_dn, &deleted_object);
+    QVERIFY(delete_success);
+}
+
 QTEST_MAIN(ADMCTestAdInterface)
@@ -44,6 +44,22 @@ private slots:
 
     void user_set_account_option();
 
+    void get_domain_hosts_cache();
+
+    void search_concurrent();
+    void search_objects();
+
+    void atom_lookup();
+    void search_vlv();
+    void modify_batch();
+    void attribute_replace_values();
+    void object_delete_list();
+    void search_cancel();
+    void attribute_descriptors();
+    void cstr();
+    void gpo_sync_perms();
+    void gpo_sync_perms_resume();
+
 private:
 };
 
@@ -357,6 +357,50 @@ void ADMCTestAdSecurity::add_to_unset_opposite_superior() {
     check_state(test_trustee, SEC_ADS_GENERIC_ALL, QByteArray(), expected_full_control);
 }
 
+void ADMCTestAdSecurity::get_trustee_name_list() {
+    ad_security_clear_trustee_name_cache();
+
+    const QByteArray user_sid = ad.search_object(test_user_dn, {ATTRIBUTE_OBJECT_SID}).get_value(ATTRIBUTE_OBJECT_SID);
+    const QByteArray trustee_sid = ad.search_object(test_trustee_dn, {ATTRIBUTE_OBJECT_SID}).get_value(ATTRIBUTE_OBJECT_SID);
+    const QByteArray world_sid = sid_string_to_bytes(SID_WORLD);
+
+    const QHash<QByteArray, QString> name_map = ad_security_get_trustee_name_list(ad, {user_sid, trustee_sid, world_sid});
+    QCOMPARE(name_map.size(), 3);
+
+    const QString user_name = ad.search_object(test_user_dn, {ATTRIBUTE_SAM_ACCOUNT_NAME}).get_string(ATTRIBUTE_SAM_ACCOUNT_NAME);
+    QCOMPARE(name_map[user_sid], user_name);
+    QCOMPARE(name_map[world_sid], ad_security_get_well_known_trustee_name(world_sid));
+
+    // Single name getter should return same names, from
+    // cache
+    QCOMPARE(ad_security_get_trustee_name(ad, trustee_sid), name_map[trustee_sid]);
+}
+
+void ADMCTestAdSecurity::right_index() {
+    const QByteArray change_pass_right = ad.adconfig()->get_right_guid("User-Change-Password");
+
+    security_descriptor_add_right(sd, ad.adconfig(), class_list, test_trustee, SEC_ADS_CREATE_CHILD, QByteArray(), true);
+    security_descriptor_add_right(sd, ad.adconfig(), class_list, test_trustee, SEC_ADS_CONTROL_ACCESS, change_pass_right, false);
+
+    const SecurityRightIndex index = SecurityRightIndex(sd, test_trustee);
+
+    const SecurityRightState create_child_state = index.get(SEC_ADS_CREATE_CHILD, QByteArray());
+    QVERIFY(create_child_state.get(SecurityRightStateInherited_No, SecurityRightStateType_Allow));
+    QVERIFY(!create_child_state.get(SecurityRightStateInherited_No, SecurityRightStateType_Deny));
+
+    const SecurityRightState change_pass_state = index.get(SEC_ADS_CONTROL_ACCESS, change_pass_right);
+    QVERIFY(!change_pass_state.get(SecurityRightStateInherited_No, SecurityRightStateType_Allow));
+    QVERIFY(change_pass_state.get(SecurityRightStateInherited_No, SecurityRightStateType_Deny));
+
+    // Ace with object type shouldn't match right without
+    // object type
+    const SecurityRightState control_access_state = index.get(SEC_ADS_CONTROL_ACCESS, QByteArray());
+    QVERIFY(!control_access_state.get(SecurityRightStateInherited_No, SecurityRightStateType_Deny));
+
+    const SecurityRightState delete_child_state = index.get(SEC_ADS_DELETE_CHILD, QByteArray());
+    QVERIFY(!delete_child_state.get(SecurityRightStateInherited_No, SecurityRightStateType_Allow));
+}
+
 void ADMCTestAdSecurity::check_state(const QByteArray &trustee, const uint32_t access_mask, const QByteArray &object_type, const TestAdSecurityType type) const {
     const SecurityRightState state = security_descriptor_get_right(sd, trustee, access_mask, object_type);
 
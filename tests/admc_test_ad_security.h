@@ -56,6 +56,8 @@ private slots:
     void remove_to_unset_superior();
     void add_to_unset_opposite_superior_data();
     void add_to_unset_opposite_superior();
+    void get_trustee_name_list();
+    void right_index();
 
 private:
     QString test_user_dn;